@@ -0,0 +1,46 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::AsyncConnection
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <future>
+#include <vector>
+#include "sqlitemm_async.hpp"
+#include "bench.hpp"
+
+SQLITEMM_BENCHMARK(async_benchmarks)
+{
+    sqlitemm::AsyncConnection conn(":memory:");
+    conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, value INTEGER)").get();
+
+    int value = 0;
+    runner.measure("async_execute_round_trip", 20000, [&conn, &value] {
+        bench::do_not_optimize(conn.execute("INSERT INTO item (value) VALUES (?)", ++value).get());
+    });
+
+    // a batch of submissions is queued before waiting on any of them, so the
+    // worker runs them back to back
+    std::vector<std::future<int>> pending;
+    pending.reserve(100);
+    runner.measure("async_execute_pipelined_100", 200, [&conn, &value, &pending] {
+        for (int i = 0; i < 100; ++i)
+        {
+            pending.push_back(conn.execute("INSERT INTO item (value) VALUES (?)", ++value));
+        }
+        for (auto& future : pending)
+        {
+            bench::do_not_optimize(future.get());
+        }
+        pending.clear();
+    });
+}
@@ -0,0 +1,45 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::Backup
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+
+#include <string>
+#include "sqlitemm.hpp"
+#include "bench.hpp"
+
+SQLITEMM_BENCHMARK(backup_benchmarks)
+{
+    sqlitemm::Connection source(":memory:");
+    source.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, content BLOB)");
+    {
+        auto insert = source.prepare("INSERT INTO item (content) VALUES (randomblob(1000))");
+        auto transaction = source.begin_transaction();
+        for (int i = 0; i < 4000; ++i)
+        {
+            insert.execute();
+            insert.reset();
+        }
+        transaction.commit();
+    }
+
+    for (int pages_per_step : {1, 16, 128, -1})
+    {
+        auto name = "backup_4MB_pages_per_step_" + (pages_per_step > 0 ? std::to_string(pages_per_step) : "all");
+        runner.measure(name, 10, [&source, pages_per_step] {
+            sqlitemm::Connection destination(":memory:");
+            sqlitemm::Backup backup(source, "main", destination, "main");
+            while (backup.step(pages_per_step)) {}
+        });
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef SQLITEMM_BENCH_20250601_H_
+#define SQLITEMM_BENCH_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm benchmarks header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal benchmark harness for sqlitemm.
+ *
+ * Each measurement is reported on standard output as one JSON object per
+ * line, e.g.:
+ *
+ *     {"benchmark": "prepare_finalize", "iterations": 10000, "repetitions": 5,
+ *      "ns_per_op": 812.4, "min_ns_per_op": 801.9, "bytes_per_second": 0}
+ *
+ * so that the output of successive releases can be compared mechanically.
+ */
+namespace bench
+{
+    /**
+     * Prevents the compiler from optimizing away the computation of value.
+     */
+    template<typename T>
+    inline void do_not_optimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * Runs and reports measurements for the benchmarks selected by the
+     * command line.
+     */
+    class Runner
+    {
+    public:
+        /**
+         * Constructs a runner that runs the benchmarks whose names contain
+         * filter, or every benchmark if filter is empty, with each measurement
+         * repeated the given number of times.
+         */
+        explicit Runner(std::string filter, size_t repetitions) :
+            filter(std::move(filter)), repetitions(repetitions) {}
+
+        /**
+         * Returns true if the benchmark with the given name is selected.
+         */
+        bool selected(const std::string& name) const
+        {
+            return filter.empty() || name.find(filter) != std::string::npos;
+        }
+
+        /**
+         * Measures op by calling it iterations times per repetition after one
+         * warm-up repetition, then reports the median and minimum time per
+         * call. If bytes_per_op is non-zero, the median throughput is also
+         * reported.
+         */
+        template<typename Op>
+        void measure(const std::string& name, size_t iterations, Op&& op, size_t bytes_per_op = 0)
+        {
+            if (!selected(name))
+            {
+                return;
+            }
+
+            std::vector<double> ns_per_op;
+            for (size_t repetition = 0; repetition <= repetitions; ++repetition)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < iterations; ++i)
+                {
+                    op();
+                }
+                auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+                if (repetition > 0)
+                {
+                    ns_per_op.push_back(elapsed.count() / iterations);
+                }
+            }
+            std::sort(ns_per_op.begin(), ns_per_op.end());
+            report(name, iterations, ns_per_op[ns_per_op.size() / 2], ns_per_op.front(), bytes_per_op);
+        }
+    private:
+        std::string filter;
+        size_t repetitions;
+
+        void report(const std::string& name, size_t iterations, double median, double minimum, size_t bytes_per_op);
+    };
+
+    /**
+     * Function that runs a group of related measurements.
+     */
+    using BenchmarkFunction = void (*)(Runner&);
+
+    /**
+     * Registers a benchmark function to be run by the benchmark executable.
+     */
+    struct Registrar
+    {
+        Registrar(BenchmarkFunction function);
+    };
+}
+
+/**
+ * Defines and registers a benchmark function taking a bench::Runner& named
+ * runner.
+ */
+#define SQLITEMM_BENCHMARK(function_name) \
+    static void function_name(bench::Runner& runner); \
+    static bench::Registrar function_name##_registrar(function_name); \
+    static void function_name(bench::Runner& runner)
+
+#endif
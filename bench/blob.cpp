@@ -0,0 +1,49 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::Blob
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+
+#include <vector>
+#include "sqlitemm.hpp"
+#include "bench.hpp"
+
+SQLITEMM_BENCHMARK(blob_benchmarks)
+{
+    constexpr size_t blob_size = 1 << 20;
+    constexpr size_t chunk_size = 1 << 16;
+
+    sqlitemm::Connection conn(":memory:");
+    conn.execute("CREATE TABLE file (id INTEGER PRIMARY KEY, content BLOB)");
+    {
+        auto insert = conn.prepare("INSERT INTO file (id, content) VALUES (1, ?)");
+        insert << sqlitemm::ZeroBlob(blob_size);
+        insert.execute();
+    }
+
+    std::vector<unsigned char> buffer(chunk_size, 0xab);
+    auto blob = conn.open_blob("main", "file", "content", 1, sqlitemm::Blob::READ_WRITE);
+
+    runner.measure("blob_write_64KiB_chunks", 2000, [&blob, &buffer] {
+        static size_t offset = 0;
+        blob.write(buffer.data(), buffer.size(), offset);
+        offset = (offset + chunk_size) % blob_size;
+    }, chunk_size);
+
+    runner.measure("blob_read_64KiB_chunks", 2000, [&blob, &buffer] {
+        static size_t offset = 0;
+        blob.read(buffer.data(), buffer.size(), offset);
+        bench::do_not_optimize(buffer[0]);
+        offset = (offset + chunk_size) % blob_size;
+    }, chunk_size);
+}
@@ -0,0 +1,79 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks main source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "sqlite3.h"
+
+namespace
+{
+    std::vector<bench::BenchmarkFunction>& benchmark_functions()
+    {
+        static std::vector<bench::BenchmarkFunction> functions;
+        return functions;
+    }
+}
+
+namespace bench
+{
+    void Runner::report(const std::string& name, size_t iterations, double median, double minimum, size_t bytes_per_op)
+    {
+        double bytes_per_second = median > 0.0 ? bytes_per_op * 1e9 / median : 0.0;
+        std::printf(
+            "{\"benchmark\": \"%s\", \"sqlite_version\": \"%s\", \"iterations\": %zu, \"repetitions\": %zu, "
+            "\"ns_per_op\": %.1f, \"min_ns_per_op\": %.1f, \"bytes_per_second\": %.0f}\n",
+            name.c_str(), sqlite3_libversion(), iterations, repetitions, median, minimum, bytes_per_second
+        );
+        std::fflush(stdout);
+    }
+
+    Registrar::Registrar(BenchmarkFunction function)
+    {
+        benchmark_functions().push_back(function);
+    }
+}
+
+/**
+ * Runs the benchmarks.
+ *
+ * Usage: bench.out [filter [repetitions]]
+ *
+ * Only measurements whose names contain filter are run, and each is repeated
+ * the given number of times (5 by default).
+ */
+int main(int argc, char* argv[])
+{
+    std::string filter = (argc > 1) ? argv[1] : "";
+    size_t repetitions = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 5;
+    bench::Runner runner(filter, repetitions > 0 ? repetitions : 1);
+    try
+    {
+        for (auto function : benchmark_functions())
+        {
+            function(runner);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "benchmark failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
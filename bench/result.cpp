@@ -0,0 +1,104 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::Result
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+
+#include <string>
+#include "sqlitemm.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    constexpr int num_rows = 1000;
+
+    struct GameResult
+    {
+        std::string name;
+        int games;
+        double score;
+
+        GameResult() = default;
+
+        explicit GameResult(sqlitemm::Result& result)
+        {
+            result >> name >> games >> score;
+        }
+    };
+}
+
+SQLITEMM_BENCHMARK(result_benchmarks)
+{
+    sqlitemm::Connection conn(":memory:");
+    conn.execute("CREATE TABLE result (id INTEGER PRIMARY KEY, name TEXT, games INTEGER, score REAL)");
+    {
+        auto insert = conn.prepare("INSERT INTO result (name, games, score) VALUES (?, ?, ?)");
+        auto transaction = conn.begin_transaction();
+        for (int i = 0; i < num_rows; ++i)
+        {
+            insert << ("player" + std::to_string(i)) << i << i * 0.5;
+            insert.execute();
+            insert.reset();
+        }
+        transaction.commit();
+    }
+
+    auto select = conn.prepare("SELECT name, games, score FROM result");
+
+    runner.measure("decode_stream_operators_1000_rows", 200, [&select] {
+        auto result = select.execute_query();
+        GameResult row;
+        while (result.step())
+        {
+            result >> row.name >> row.games >> row.score;
+            bench::do_not_optimize(row.games);
+        }
+    });
+
+    runner.measure("decode_result_iterator_1000_rows", 200, [&select] {
+        auto result = select.execute_query();
+        for (auto it = result.begin<GameResult>(); it != result.end<GameResult>(); ++it)
+        {
+            bench::do_not_optimize((*it).games);
+        }
+    });
+
+    runner.measure("decode_result_fields_1000_rows", 200, [&select] {
+        auto result = select.execute_query();
+        GameResult row;
+        while (result.step())
+        {
+            row.name = static_cast<std::string>(result[0]);
+            row.games = result[1];
+            row.score = result[2];
+            bench::do_not_optimize(row.games);
+        }
+    });
+
+    runner.measure("decode_typed_rows_1000_rows", 200, [&select] {
+        auto result = select.execute_query();
+        for (auto row : result.rows<std::string_view, int, double>())
+        {
+            bench::do_not_optimize(std::get<1>(row));
+        }
+    });
+
+    runner.measure("decode_column_batches_1000_rows", 200, [&select] {
+        auto result = select.execute_query();
+        sqlitemm::ColumnBatch batch;
+        while (result.fetch_columns(batch, 256) > 0)
+        {
+            bench::do_not_optimize(batch[1].integers().back());
+        }
+    });
+}
@@ -0,0 +1,59 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::ResultWriter
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <sstream>
+#include <string>
+#include "sqlitemm_result_writer.hpp"
+#include "bench.hpp"
+
+SQLITEMM_BENCHMARK(result_writer_benchmarks)
+{
+    sqlitemm::Connection conn(":memory:");
+    conn.execute("CREATE TABLE result (id INTEGER PRIMARY KEY, name TEXT, games INTEGER, score REAL)");
+    conn.execute("WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 10000) "
+                 "INSERT INTO result (name, games, score) SELECT 'player ' || x, x % 100, x / 7.0 FROM n");
+    auto select = conn.prepare("SELECT id, name, games, score FROM result");
+
+    size_t bytes_written = 0;
+    auto count_bytes = [&bytes_written](const unsigned char*, size_t size) { bytes_written += size; };
+
+    // the rows formatted through std::string fields and iostreams, for comparison
+    runner.measure("export_csv_ostringstream_table", 20, [&select, &bytes_written] {
+        std::ostringstream out;
+        auto result = select.query();
+        while (result.step())
+        {
+            out << static_cast<std::string>(result[0]) << ',' << static_cast<std::string>(result[1]) << ','
+                << static_cast<std::string>(result[2]) << ',' << static_cast<std::string>(result[3]) << "\r\n";
+        }
+        bytes_written += out.str().size();
+    });
+
+    for (auto format : {sqlitemm::ResultFormat::Csv, sqlitemm::ResultFormat::NdJson, sqlitemm::ResultFormat::Binary})
+    {
+        const char* name = (format == sqlitemm::ResultFormat::Csv) ? "export_csv_result_writer_table"
+                         : (format == sqlitemm::ResultFormat::NdJson) ? "export_ndjson_result_writer_table"
+                                                                      : "export_binary_result_writer_table";
+        sqlitemm::ResultWriterOptions options;
+        options.format = format;
+        sqlitemm::ResultWriter writer(count_bytes, options);
+        runner.measure(name, 20, [&select, &writer] {
+            auto result = select.query();
+            writer.write(result);
+            writer.finish();
+        });
+    }
+    bench::do_not_optimize(bytes_written);
+}
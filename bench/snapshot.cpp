@@ -0,0 +1,58 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking read-only snapshot connections
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstdio>
+#include <string>
+#include "sqlitemm_snapshot.hpp"
+#include "bench.hpp"
+
+SQLITEMM_BENCHMARK(snapshot_benchmarks)
+{
+    const std::string filename = "bench_snapshot.db";
+    std::remove(filename.c_str());
+    {
+        sqlitemm::Connection conn(filename);
+        conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);"
+                     "WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 100000) "
+                     "INSERT INTO item (id, name) SELECT x, printf('%0100d', x) FROM n;");
+    }
+
+    auto measure_lookups = [&runner](const std::string& name, sqlitemm::Connection& conn) {
+        auto lookup = conn.prepare("SELECT name FROM item WHERE id = ?");
+        long long id = 0;
+        runner.measure(name, 200000, [&lookup, &id] {
+            id = id * 48271 % 100000 + 1;
+            auto result = lookup.query(id);
+            bench::do_not_optimize(result.step());
+        });
+    };
+
+    {
+        sqlitemm::Connection conn(filename, SQLITE_OPEN_READONLY);
+        measure_lookups("lookup_readonly", conn);
+    }
+    {
+        sqlitemm::Connection conn;
+        conn.open_readonly_snapshot(filename);
+        measure_lookups("lookup_readonly_snapshot", conn);
+    }
+    {
+        sqlitemm::SharedSnapshot snapshot(filename);
+        auto conn = snapshot.connect();
+        measure_lookups("lookup_shared_snapshot", conn);
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,126 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::Statement
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+
+#include <string>
+#include <string_view>
+#include "sqlitemm.hpp"
+#include "bench.hpp"
+
+SQLITEMM_BENCHMARK(statement_benchmarks)
+{
+    sqlitemm::Connection conn(":memory:");
+    conn.execute("CREATE TABLE result (id INTEGER PRIMARY KEY, name TEXT, games INTEGER, score REAL)");
+
+    runner.measure("prepare_finalize", 20000, [&conn] {
+        auto statement = conn.prepare("SELECT name, games, score FROM result WHERE id = ?");
+        statement.finalize();
+    });
+
+    conn.set_statement_cache_capacity(16);
+    runner.measure("prepare_cached_finalize", 20000, [&conn] {
+        auto statement = conn.prepare_cached("SELECT name, games, score FROM result WHERE id = ?");
+        statement.finalize();
+    });
+    conn.set_statement_cache_capacity(0);
+
+    const std::string name = "Alice";
+    auto positional = conn.prepare("SELECT ?, ?, ?, ?");
+    runner.measure("bind_positional", 200000, [&positional, &name] {
+        positional << 1 << name << 20 << 12.5;
+        positional.reset();
+    });
+
+    const std::string long_name(4096, 'a');
+    runner.measure("bind_moved_string", 200000, [&positional, &long_name] {
+        positional << 1 << std::string(long_name) << 20 << 12.5;
+        positional.reset();
+    }, long_name.size());
+
+    runner.measure("bind_string_view", 200000, [&positional, &long_name] {
+        positional << 1 << std::string_view(long_name) << 20 << 12.5;
+        positional.reset();
+    }, long_name.size());
+
+    auto named = conn.prepare("SELECT :id, :name, :games, :score");
+    runner.measure("bind_named", 200000, [&named, &name] {
+        named[":id"] = 1;
+        named[":name"] = name;
+        named[":games"] = 20;
+        named[":score"] = 12.5;
+    });
+
+    auto id = named.parameter(":id");
+    auto name_parameter = named.parameter(":name");
+    auto games = named.parameter(":games");
+    auto score = named.parameter(":score");
+    runner.measure("bind_named_handles", 200000, [&] {
+        id = 1;
+        name_parameter = name;
+        games = 20;
+        score = 12.5;
+    });
+
+    auto insert = conn.prepare("INSERT INTO result (name, games, score) VALUES (?, ?, ?)");
+    conn.execute("BEGIN");
+    runner.measure("execute_insert", 100000, [&insert, &name] {
+        insert << name << 20 << 12.5;
+        insert.execute();
+        insert.reset();
+    });
+    conn.execute("COMMIT");
+
+    conn.execute("BEGIN");
+    runner.measure("execute_insert_variadic", 100000, [&insert, &name] {
+        insert.execute(name, 20, 12.5);
+    });
+    conn.execute("COMMIT");
+
+    auto duplicate = conn.prepare("INSERT INTO result (id, name, games, score) VALUES (1, 'Bob', 10, 5.0)");
+    runner.measure("execute_constraint_throwing", 50000, [&duplicate] {
+        try
+        {
+            duplicate.execute();
+        }
+        catch (const sqlitemm::ConstraintError&)
+        {
+        }
+        try
+        {
+            duplicate.reset();
+        }
+        catch (const sqlitemm::ConstraintError&)
+        {
+        }
+    });
+
+    runner.measure("execute_constraint_status", 50000, [&duplicate] {
+        bench::do_not_optimize(duplicate.try_execute().constraint_violation());
+        duplicate.try_reset();
+    });
+
+    const std::string script_sql =
+        "UPDATE result SET games = games + 1 WHERE id = 1;"
+        "UPDATE result SET score = score + 0.5 WHERE id = 1;"
+        "DELETE FROM result WHERE id < 0;";
+    runner.measure("execute_script_sqlite3_exec", 50000, [&conn, &script_sql] {
+        conn.execute(script_sql);
+    });
+
+    auto script = conn.prepare_script(script_sql);
+    runner.measure("execute_script_prepared", 50000, [&script] {
+        script.execute();
+    });
+}
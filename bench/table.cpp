@@ -0,0 +1,72 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::Table
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <string>
+#include "sqlitemm_table.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    struct Player
+    {
+        long long id = 0;
+        std::string name;
+        long long games = 0;
+        double score = 0.0;
+    };
+}
+
+SQLITEMM_BENCHMARK(table_benchmarks)
+{
+    sqlitemm::Connection conn(":memory:");
+    conn.execute("CREATE TABLE player (id INTEGER PRIMARY KEY, name TEXT, games INTEGER, score REAL)");
+    sqlitemm::Table players(
+        conn, "player",
+        sqlitemm::column("id", &Player::id),
+        sqlitemm::column("name", &Player::name),
+        sqlitemm::column("games", &Player::games),
+        sqlitemm::column("score", &Player::score)
+    );
+
+    conn.execute("BEGIN");
+    long long next_id = 0;
+    runner.measure("table_insert", 100000, [&players, &next_id] {
+        players.insert(Player{++next_id, "Alice", 20, 12.5});
+    });
+    conn.execute("COMMIT");
+
+    long long id = 0;
+    runner.measure("table_find", 200000, [&players, &id, next_id] {
+        id = id % next_id + 1;
+        bench::do_not_optimize(players.find(id));
+    });
+
+    // the same lookup decoded by column name, for comparison
+    auto find_by_name = conn.prepare("SELECT id, name, games, score FROM player WHERE id = ?");
+    runner.measure("table_find_by_column_name", 200000, [&find_by_name, &id, next_id] {
+        id = id % next_id + 1;
+        auto result = find_by_name.query(id);
+        Player player;
+        if (result.step())
+        {
+            player.id = result["id"];
+            player.name = static_cast<std::string>(result["name"]);
+            player.games = result["games"];
+            player.score = result["score"];
+        }
+        find_by_name.try_reset();
+        bench::do_not_optimize(player);
+    });
+}
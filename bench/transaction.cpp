@@ -0,0 +1,53 @@
+/************************************************************************************************************
+ * SQLitemm benchmarks source file primarily for benchmarking sqlitemm::Transaction
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+
+#include <cstdio>
+#include <string>
+#include "sqlitemm.hpp"
+#include "bench.hpp"
+
+SQLITEMM_BENCHMARK(transaction_benchmarks)
+{
+    const std::string filename = "bench_transaction.db";
+    std::remove(filename.c_str());
+    std::remove((filename + "-wal").c_str());
+    std::remove((filename + "-shm").c_str());
+    {
+        sqlitemm::Connection conn(filename);
+        conn.execute("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;");
+        conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, quantity INTEGER)");
+        auto insert = conn.prepare("INSERT INTO item (quantity) VALUES (?)");
+
+        runner.measure("transaction_commit_1_row_wal", 1000, [&conn, &insert] {
+            auto transaction = conn.begin_transaction();
+            insert << 1;
+            insert.execute();
+            insert.reset();
+            transaction.commit();
+        });
+
+        runner.measure("transaction_rollback_1_row_wal", 1000, [&conn, &insert] {
+            auto transaction = conn.begin_transaction();
+            insert << 1;
+            insert.execute();
+            insert.reset();
+            transaction.rollback();
+        });
+    }
+    std::remove(filename.c_str());
+    std::remove((filename + "-wal").c_str());
+    std::remove((filename + "-shm").c_str());
+}
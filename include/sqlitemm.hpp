@@ -16,14 +16,22 @@
  * See the License for the specific language governing permissions and limitations under the License.
  ************************************************************************************************************/
 
+#include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <new>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include "sqlite3.h"
 
@@ -34,15 +42,333 @@ namespace sqlitemm
 {
     class Backup;
     class Blob;
+    class ColumnBatch;
     class Connection;
     class Parameter;
     class Result;
     class ResultField;
     template<typename T>
     class ResultIterator;
+    template<typename Decoder>
+    class RowRange;
+    template<typename... Ts>
+    struct TupleRowDecoder;
+    template<typename T, typename... Members>
+    struct MemberRowDecoder;
+    class Savepoint;
+    class Script;
     class Statement;
+    class StatementProfiler;
+    class StatementRegistry;
     class Transaction;
 
+    /**
+     * Implementation details shared by the sqlitemm classes.
+     */
+    namespace detail
+    {
+        template<typename T>
+        struct is_optional : std::false_type {};
+
+        template<typename T>
+        struct is_optional<std::optional<T>> : std::true_type {};
+    }
+
+    /**
+     * Counters describing the effectiveness of a database connection's
+     * prepared statement cache.
+     */
+    struct StatementCacheStats
+    {
+        /// Number of requests for a cached statement served from the cache.
+        unsigned long long hits = 0;
+        /// Number of requests for a cached statement that had to prepare it.
+        unsigned long long misses = 0;
+        /// Number of idle statements finalized to stay within the capacity.
+        unsigned long long evictions = 0;
+    };
+
+    /**
+     * Models the outcome of a call to the non-throwing counterpart of a
+     * throwing member function, e.g., Statement::try_execute() for
+     * Statement::execute().
+     *
+     * A status only holds the SQLite result code and the database connection
+     * handle, so errors that are expected outcomes, e.g., SQLITE_BUSY or
+     * SQLITE_CONSTRAINT, can be handled without allocating an error message
+     * or unwinding the stack.
+     */
+    class Status
+    {
+    public:
+        /**
+         * Constructs a status indicating success.
+         */
+        Status() noexcept = default;
+
+        /**
+         * Constructs a status from a SQLite result code, and the handle of
+         * the database connection that reported it for the error message.
+         */
+        explicit Status(int code, sqlite3* db = nullptr) noexcept : result_code(code), db(db) {}
+
+        /**
+         * Returns the (extended) SQLite result code.
+         */
+        int code() const noexcept
+        {
+            return result_code;
+        }
+
+        /**
+         * Returns the primary SQLite result code.
+         */
+        int primary_code() const noexcept
+        {
+            return result_code & 0xff;
+        }
+
+        /**
+         * Returns true if the result code does not indicate an error, i.e.,
+         * it is SQLITE_OK, SQLITE_ROW or SQLITE_DONE.
+         */
+        bool ok() const noexcept
+        {
+            return result_code == SQLITE_OK || result_code == SQLITE_ROW || result_code == SQLITE_DONE;
+        }
+
+        /**
+         * Converts the status to bool by returning ok().
+         */
+        explicit operator bool() const noexcept
+        {
+            return ok();
+        }
+
+        /**
+         * Returns true if a step produced a result row.
+         */
+        bool has_row() const noexcept
+        {
+            return result_code == SQLITE_ROW;
+        }
+
+        /**
+         * Returns true if the error is SQLITE_BUSY or one of its extended
+         * result codes.
+         */
+        bool busy() const noexcept
+        {
+            return primary_code() == SQLITE_BUSY;
+        }
+
+        /**
+         * Returns true if the error is SQLITE_CONSTRAINT or one of its
+         * extended result codes.
+         */
+        bool constraint_violation() const noexcept
+        {
+            return primary_code() == SQLITE_CONSTRAINT;
+        }
+
+        /**
+         * Returns the error message, built on demand.
+         *
+         * The message reported by the database connection is only available
+         * until the next call that can fail on that database connection, after
+         * which the generic description of the result code is returned.
+         */
+        std::string message() const;
+
+        /**
+         * Throws the exception that the throwing counterpart would have
+         * thrown if ok() is false.
+         */
+        void throw_if_error() const;
+    private:
+        int result_code = SQLITE_OK; // SQLite result code
+        sqlite3* db = nullptr;       // database connection handle for the error message
+    };
+
+    /**
+     * Number of buckets in the latency histogram of a statement profile.
+     */
+    constexpr size_t statement_latency_buckets = 24;
+
+    /**
+     * Counters accumulated by a database connection with profiling enabled
+     * over every execution of the prepared statements with the same SQL text.
+     */
+    struct StatementProfile
+    {
+        /// SQL text of the prepared statements.
+        std::string sql;
+        /// Number of times the prepared statements were executed to completion or reset.
+        unsigned long long calls = 0;
+        /// Total wall clock time of those executions, in nanoseconds.
+        unsigned long long total_nanoseconds = 0;
+        /// Number of executions by latency: bucket i counts executions that
+        /// took less than 2^(i + 10) nanoseconds (about 2^i microseconds) but
+        /// not less than the bound of bucket i - 1, with the last bucket also
+        /// counting every slower execution.
+        std::array<unsigned long long, statement_latency_buckets> latency_histogram{};
+        /// Number of forward steps in a full table scan.
+        unsigned long long fullscan_steps = 0;
+        /// Number of sort operations.
+        unsigned long long sorts = 0;
+        /// Number of rows inserted into automatic indexes.
+        unsigned long long autoindex_rows = 0;
+        /// Number of virtual machine operations.
+        unsigned long long vm_steps = 0;
+    };
+
+    /**
+     * Connection-level counters reported by sqlite3_db_status.
+     */
+    struct DatabaseStatus
+    {
+        /// Number of page cache hits.
+        long long cache_hits = 0;
+        /// Number of page cache misses.
+        long long cache_misses = 0;
+        /// Number of dirty page cache entries written to disk.
+        long long cache_writes = 0;
+        /// Number of dirty page cache entries written to disk mid-transaction.
+        long long cache_spills = 0;
+        /// Approximate number of bytes of heap memory used by the page cache.
+        long long cache_used_bytes = 0;
+        /// Approximate number of bytes of heap memory used to store the schema.
+        long long schema_used_bytes = 0;
+        /// Approximate number of bytes of heap and lookaside memory used by prepared statements.
+        long long statement_used_bytes = 0;
+        /// Number of lookaside memory slots currently in use.
+        long long lookaside_used = 0;
+        /// Number of allocations served from lookaside memory.
+        long long lookaside_hits = 0;
+        /// Number of allocations that were too large for a lookaside slot, or
+        /// that found every lookaside slot in use, and so went to the heap.
+        long long lookaside_misses = 0;
+    };
+
+    /**
+     * Locking behaviour of a transaction when it begins.
+     */
+    enum class TransactionMode
+    {
+        /// Acquire locks only when the database is first read or written.
+        Deferred,
+        /// Acquire the write lock immediately, so that a write transaction
+        /// cannot fail with SQLITE_BUSY part way through when upgrading its
+        /// lock.
+        Immediate,
+        /// As Immediate, but also prevent other connections from reading in
+        /// journal modes other than WAL.
+        Exclusive
+    };
+
+    /**
+     * Journal modes of a database, as set by PRAGMA journal_mode.
+     */
+    enum class JournalMode
+    {
+        Delete,
+        Truncate,
+        Persist,
+        Memory,
+        Wal,
+        Off
+    };
+
+    /**
+     * Synchronous levels of a database connection, as set by PRAGMA
+     * synchronous.
+     */
+    enum class Synchronous
+    {
+        Off,
+        Normal,
+        Full,
+        Extra
+    };
+
+    /**
+     * Storage of temporary tables and indices, as set by PRAGMA temp_store.
+     */
+    enum class TempStore
+    {
+        Default,
+        File,
+        Memory
+    };
+
+    /**
+     * Modes of a WAL checkpoint, as for sqlite3_wal_checkpoint_v2().
+     */
+    enum class CheckpointMode
+    {
+        /// Checkpoint as many frames as possible without waiting for readers or writers.
+        Passive,
+        /// Wait for writers, then checkpoint every frame.
+        Full,
+        /// As Full, then wait for readers so that the next writer restarts the WAL from the beginning.
+        Restart,
+        /// As Restart, then truncate the WAL file to zero bytes.
+        Truncate
+    };
+
+    /**
+     * Outcome of a WAL checkpoint.
+     */
+    struct CheckpointResult
+    {
+        /// Number of frames in the WAL, or -1 if the database is not in WAL mode.
+        int wal_frames = 0;
+        /// Number of frames in the WAL that have been checkpointed, or -1 if
+        /// the database is not in WAL mode.
+        int checkpointed_frames = 0;
+        /// True if a checkpoint other than a passive one could not be
+        /// completed because of other connections or a busy handler timeout.
+        bool busy = false;
+    };
+
+    /**
+     * Options applied to a database connection when it is opened.
+     *
+     * Options that are not set leave the SQLite defaults in place.
+     */
+    struct ConnectionOptions
+    {
+        /// Flags for sqlite3_open_v2().
+        int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+        /// Name of the VFS module to use, or empty for the default.
+        std::string vfs;
+
+        /// Size in bytes of each lookaside memory slot, or 0 for the default.
+        int lookaside_slot_size = 0;
+        /// Number of lookaside memory slots, or 0 for the default.
+        int lookaside_slot_count = 0;
+        /// If true, the lookaside slots are carved out of a single arena
+        /// allocated by the Connection when it is opened and freed when it is
+        /// closed, rather than out of memory that SQLite allocates. Sizing the
+        /// lookaside slots to fit the connection's workload lets the small,
+        /// short-lived allocations of preparing and stepping statements be
+        /// served from the arena without calling malloc.
+        bool lookaside_arena = false;
+
+        /// PRAGMA cache_size: a number of pages if positive, or a number of
+        /// KiB if negative.
+        std::optional<int> cache_size;
+        /// PRAGMA mmap_size: the maximum number of bytes of the database file
+        /// to access through memory-mapped I/O, or 0 to disable it.
+        std::optional<long long> mmap_size;
+        /// PRAGMA temp_store.
+        std::optional<TempStore> temp_store;
+        /// PRAGMA journal_mode, which persists in the database file for WAL.
+        std::optional<JournalMode> journal_mode;
+        /// PRAGMA synchronous.
+        std::optional<Synchronous> synchronous;
+    };
+
     /**
      * Models a SQLite database connection.
      */
@@ -86,12 +412,27 @@ namespace sqlitemm
             open(filename, flags, vfs);
         }
 
+        /**
+         * Constructs a database connection by connecting to the database
+         * specified by filename, then applying the options.
+         */
+        Connection(const std::string& filename, const ConnectionOptions& options)
+        {
+            open(filename, options);
+        }
+
         /**
          * Move constructs the database connection.
          */
-        Connection(Connection&& other) noexcept : db(other.db)
+        Connection(Connection&& other) noexcept :
+            db(other.db), registry(other.registry), profiler(other.profiler), lookaside_arena(other.lookaside_arena),
+            wal_hook(other.wal_hook)
         {
             other.db = nullptr;
+            other.registry = nullptr;
+            other.profiler = nullptr;
+            other.lookaside_arena = nullptr;
+            other.wal_hook = nullptr;
         }
 
         /**
@@ -101,7 +442,10 @@ namespace sqlitemm
         {
             using std::swap;
             swap(db, other.db);
-            swap(stmt_ptrs, other.stmt_ptrs);
+            swap(registry, other.registry);
+            swap(profiler, other.profiler);
+            swap(lookaside_arena, other.lookaside_arena);
+            swap(wal_hook, other.wal_hook);
             return *this;
         }
 
@@ -129,6 +473,47 @@ namespace sqlitemm
          */
         void open(const std::string& filename, int flags, const std::string& vfs = std::string{});
 
+        /**
+         * Connects to the database given by filename with the flags and VFS
+         * module name of options, then applies the rest of the options,
+         * starting with the lookaside memory configuration.
+         *
+         * Throws sqlitemm::Error if the database cannot be opened or an option
+         * cannot be applied, in which case the database connection is closed.
+         */
+        void open(const std::string& filename, const ConnectionOptions& options);
+
+        /**
+         * Connects to the database given by filename as a read-only snapshot
+         * for lookups, i.e., with SQLITE_OPEN_READONLY, the immutable=1 URI
+         * parameter so that SQLite neither locks the file nor checks it for
+         * changes, a private cache, and the whole file memory-mapped so that
+         * pages are read from the mapping rather than copied into the page
+         * cache.
+         *
+         * The memory mapping is limited to SQLITE_MAX_MMAP_SIZE, which is just
+         * under 2 GB in a default build of SQLite, beyond which pages are
+         * read through the page cache. sqlitemm_sqlite3_config.h raises the
+         * limit on 64-bit platforms; otherwise only SharedSnapshot, which maps
+         * the file itself, avoids it.
+         *
+         * The database file must not be changed while it is open as a
+         * snapshot, otherwise queries may return incorrect results or report
+         * a corrupt database.
+         */
+        void open_readonly_snapshot(const std::string& filename);
+
+        /**
+         * Connects to the database whose image, i.e., the content of its file,
+         * is the size bytes at image, as a read-only snapshot for lookups.
+         *
+         * Pages are read from the image in place, so any number of database
+         * connections can share a single copy of it, e.g., a file mapped into
+         * memory once by SharedSnapshot. The image must neither be changed
+         * nor released until the database connection has been closed.
+         */
+        void open_readonly_snapshot(const unsigned char* image, std::size_t size);
+
         /**
          * Closes the database connection if it is open.
          */
@@ -160,9 +545,66 @@ namespace sqlitemm
         Statement prepare(const std::string& sql);
 
         /**
-         * Begins a transaction and returns it.
+         * Returns a prepared statement for the single SQL statement
+         * specified by the sql parameter, reusing an idle prepared statement
+         * from the statement cache if one was prepared from the same SQL.
+         *
+         * When the returned statement is destroyed or finalized, it is reset
+         * with its bindings cleared and returned to the statement cache
+         * instead of being finalized. If the statement cache is disabled,
+         * this is equivalent to prepare().
+         */
+        Statement prepare_cached(const std::string& sql);
+
+        /**
+         * Returns a script of the zero or more UTF-8 encoded,
+         * semicolon-separated SQL statements specified by the sql parameter,
+         * each of which is prepared once, the first time that the script
+         * executes it, and reused each time the script is executed again.
+         *
+         * Unlike execute(), parameters can be bound, and results read, for
+         * every statement of the script.
+         */
+        Script prepare_script(const std::string& sql);
+
+        /**
+         * Sets the maximum number of idle prepared statements that the
+         * statement cache retains, finalizing the least recently used idle
+         * statements if there are more than that.
+         *
+         * The statement cache is disabled by default, i.e., with a capacity
+         * of 0. The database connection must be open.
+         */
+        void set_statement_cache_capacity(size_t capacity);
+
+        /**
+         * Returns the maximum number of idle prepared statements that the
+         * statement cache retains.
+         */
+        size_t statement_cache_capacity() const noexcept;
+
+        /**
+         * Returns the hit, miss and eviction counters of the statement cache.
+         */
+        StatementCacheStats statement_cache_stats() const noexcept;
+
+        /**
+         * Begins a transaction with the given mode and returns it.
+         *
+         * The BEGIN, COMMIT and ROLLBACK statements are prepared once per
+         * database connection and reused for every transaction.
+         */
+        Transaction begin_transaction(TransactionMode mode = TransactionMode::Deferred);
+
+        /**
+         * Begins a savepoint and returns it.
+         *
+         * If there is no transaction in progress, the savepoint begins one
+         * that is committed when the savepoint is released. The SAVEPOINT,
+         * RELEASE and ROLLBACK TO statements are prepared once per database
+         * connection and reused for every savepoint.
          */
-        Transaction begin_transaction();
+        Savepoint begin_savepoint();
 
         /**
          * Opens a blob for incremental I/O and returns the blob object.
@@ -178,13 +620,207 @@ namespace sqlitemm
          * by the relevant execute or step function.
          */
         void set_busy_timeout(int ms) noexcept;
+
+        /**
+         * Registers the callable f as a scalar SQL function with the given
+         * name, replacing any SQL function with the same name and number of
+         * arguments.
+         *
+         * The number and types of the arguments of the SQL function, and its
+         * return type, are deduced from f at compile time, so f must not be
+         * overloaded or generic. The arguments may be bool, integer, floating
+         * point, std::string, std::string_view, BlobView or std::optional of
+         * those, and are converted from their SQL values as by the
+         * sqlite3_value_* functions, with std::optional receiving NULL as an
+         * empty value. Views are only valid until f returns. f may return
+         * void (i.e., NULL), std::nullptr_t, or any of the argument types,
+         * std::u16string, const char* or ZeroBlob. An exception thrown by f
+         * is reported as an error by the statement that called the SQL
+         * function.
+         *
+         * flags may contain SQLITE_DETERMINISTIC, which allows the query
+         * planner to evaluate the SQL function once for constant arguments,
+         * as well as SQLITE_DIRECTONLY or SQLITE_INNOCUOUS.
+         */
+        template<typename F>
+        void create_function(const std::string& name, F f, int flags = 0);
+
+        /**
+         * Registers an aggregate SQL function with the given name, replacing
+         * any SQL function with the same name and number of arguments.
+         *
+         * For each group, a default constructed object of type State is
+         * stored in the aggregate context allocated by SQLite instead of on
+         * the heap, and each row is passed to its step member function, after
+         * which the return value of its finalize member function is the
+         * result of the aggregate. If there are no rows, a default constructed
+         * State is finalized. The arguments of step and the return type of
+         * finalize are deduced, and may be of the types described for
+         * create_function(), as may flags.
+         */
+        template<typename State>
+        void create_aggregate(const std::string& name, int flags = 0);
+
+        /**
+         * Starts recording a StatementProfile for each SQL text executed by
+         * prepared statements of the database connection, if not already
+         * recording. The database connection must be open.
+         *
+         * Recording uses sqlite3_trace_v2, replacing any other trace callback,
+         * and resets the sqlite3_stmt_status counters of each statement after
+         * every execution. It only takes a lock the first time a SQL text is
+         * executed.
+         */
+        void enable_profiling();
+
+        /**
+         * Stops recording statement profiles and discards those recorded.
+         */
+        void disable_profiling() noexcept;
+
+        /**
+         * Returns true if statement profiles are being recorded.
+         */
+        bool profiling_enabled() const noexcept
+        {
+            return profiler != nullptr;
+        }
+
+        /**
+         * Returns a snapshot of the statement profiles recorded so far, in the
+         * order their SQL texts were first executed.
+         *
+         * This may be called from another thread while the database
+         * connection is in use, but not concurrently with enabling or
+         * disabling profiling, or closing the database connection.
+         */
+        std::vector<StatementProfile> statement_profiles() const;
+
+        /**
+         * Returns the connection-level counters, resetting the resettable
+         * counters to zero afterwards if reset is true. The database
+         * connection must be open.
+         */
+        DatabaseStatus database_status(bool reset = false) const;
+
+        /**
+         * Runs a checkpoint of the WAL of the database with the given schema
+         * name, or of every attached database in WAL mode if schema_name is
+         * empty.
+         *
+         * Failing to complete a checkpoint because of other connections is
+         * reported through CheckpointResult::busy rather than by throwing
+         * sqlitemm::BusyError. Other errors throw sqlitemm::Error.
+         */
+        CheckpointResult checkpoint(CheckpointMode mode = CheckpointMode::Passive,
+                                    const std::string& schema_name = std::string{});
+
+        /**
+         * Sets the number of frames in the WAL at which a committing
+         * transaction runs a passive checkpoint, or disables automatic
+         * checkpoints if wal_frames is zero or negative.
+         *
+         * This replaces any function set through set_wal_hook(), and vice
+         * versa.
+         */
+        void set_wal_autocheckpoint(int wal_frames);
+
+        /**
+         * Sets a function to be called with the schema name of the database
+         * and the number of frames in its WAL after each transaction is
+         * committed to a database in WAL mode, or removes the function if
+         * hook is empty.
+         *
+         * The function is called on the thread that committed the
+         * transaction, and must not throw an exception. Setting it disables
+         * automatic checkpoints, as for set_wal_autocheckpoint(0).
+         */
+        void set_wal_hook(std::function<void(const char* schema_name, int wal_frames)> hook);
     private:
         sqlite3* db = nullptr; // database connection handle
-        // prepared statements that were prepared via this database connection
-        std::vector<std::weak_ptr<sqlite3_stmt*>> stmt_ptrs;
+        // registry of the prepared statements that were prepared via this
+        // database connection, including the statement cache
+        StatementRegistry* registry = nullptr;
+        // statement profiles recorded while profiling is enabled
+        StatementProfiler* profiler = nullptr;
+        // memory for the lookaside slots if ConnectionOptions::lookaside_arena was set
+        unsigned char* lookaside_arena = nullptr;
+        // function called after each transaction is committed in WAL mode
+        std::function<void(const char*, int)>* wal_hook = nullptr;
+
+        void apply_options(const ConnectionOptions& options);
+
+        // deduces the return type and argument types of a callable that is not overloaded
+        template<typename F>
+        struct callable_traits : callable_traits<decltype(&F::operator())> {};
+
+        template<typename R, typename... Args>
+        struct callable_traits<R(*)(Args...)>
+        {
+            using return_type = R;
+            using argument_types = std::tuple<std::decay_t<Args>...>;
+        };
+
+        template<typename R, typename... Args>
+        struct callable_traits<R(*)(Args...) noexcept> : callable_traits<R(*)(Args...)> {};
+
+        template<typename R, typename C, typename... Args>
+        struct callable_traits<R(C::*)(Args...)> : callable_traits<R(*)(Args...)> {};
+
+        template<typename R, typename C, typename... Args>
+        struct callable_traits<R(C::*)(Args...) noexcept> : callable_traits<R(*)(Args...)> {};
+
+        template<typename R, typename C, typename... Args>
+        struct callable_traits<R(C::*)(Args...) const> : callable_traits<R(*)(Args...)> {};
+
+        template<typename R, typename C, typename... Args>
+        struct callable_traits<R(C::*)(Args...) const noexcept> : callable_traits<R(*)(Args...)> {};
+
+        // aggregate context of an aggregate SQL function, zero filled by SQLite when allocated
+        template<typename State>
+        struct AggregateStorage
+        {
+            alignas(State) unsigned char state[sizeof(State)];
+            bool constructed;
+        };
+
+        // owns the user data of a SQL function until SQLite takes ownership of it
+        using FunctionUserData = std::unique_ptr<void, void (*)(void*)>;
+
+        void register_function(
+            const std::string& name,
+            int num_args,
+            int flags,
+            FunctionUserData user_data,
+            void (*scalar_function)(sqlite3_context*, int, sqlite3_value**),
+            void (*step_function)(sqlite3_context*, int, sqlite3_value**),
+            void (*final_function)(sqlite3_context*)
+        );
+
+        // sets the result of the SQL function to an error for the exception being handled
+        static void set_function_error(sqlite3_context* context) noexcept;
+
+        template<typename T>
+        static T function_argument(sqlite3_value* value);
+
+        template<typename T>
+        static void set_function_result(sqlite3_context* context, T&& value);
+
+        template<typename Args, typename F, size_t... Is>
+        static void invoke_function(sqlite3_context* context, F&& f, sqlite3_value** values, std::index_sequence<Is...>);
+
+        template<typename F>
+        static void call_scalar_function(sqlite3_context* context, int num_values, sqlite3_value** values) noexcept;
+
+        template<typename State>
+        static void step_aggregate(sqlite3_context* context, int num_values, sqlite3_value** values) noexcept;
+
+        template<typename State>
+        static void finalize_aggregate(sqlite3_context* context) noexcept;
 
-        void clean_stmt_ptrs();
         friend class Backup;
+        friend class ChangesetConflict;
+        friend class Session;
     };
 
     /**
@@ -199,6 +835,22 @@ namespace sqlitemm
      */
     void detach(Connection& connection, const std::string& schema_name);
 
+    /**
+     * Gives SQLite a preallocated arena of page_count slots of slot_size
+     * bytes each for its page cache, shared by all database connections,
+     * through sqlite3_config(SQLITE_CONFIG_PAGECACHE).
+     *
+     * slot_size should be the database page size plus a small header, e.g.,
+     * 4096 + 128 bytes. Pages that do not fit in the arena are allocated as
+     * usual. The arena is never freed, since SQLite may use it until the
+     * process exits.
+     *
+     * This must be called before SQLite is initialized, i.e., before any
+     * database connection is opened; otherwise sqlitemm::Error is thrown with
+     * SQLITE_MISUSE.
+     */
+    void configure_page_cache(int slot_size, int page_count);
+
     /**
      * Models an online database backup.
      */
@@ -218,6 +870,9 @@ namespace sqlitemm
          * main database, "temp" for the temporary database, or the name
          * specified after the AS keyword in an ATTACH statement for an
          * attached database.
+         *
+         * Throws sqlitemm::Error if the backup cannot be initialised, e.g.,
+         * because the destination database is in use.
          */
         Backup(Connection& source, const std::string& source_database,
                Connection& destination, const std::string& destination_database);
@@ -339,56 +994,149 @@ namespace sqlitemm
     };
 
     /**
-     * Models a blob for incremental I/O.
+     * Models a non-owning view of the bytes of a BLOB, analogous to
+     * std::string_view.
      */
-    class Blob
+    class BlobView
     {
     public:
-        /// Flag to open the blob for reading only.
-        static constexpr int READ_ONLY = 0;
-        /// Flag to open the blob for both reading and writing.
-        static constexpr int READ_WRITE = 1;
+        using value_type = unsigned char;
+        using size_type = size_t;
+        using const_iterator = const unsigned char*;
+        using iterator = const_iterator;
 
-        Blob() = delete;
-        Blob(const Blob& other) = delete;
-        void operator=(const Blob& other) = delete;
+        /**
+         * Constructs an empty BLOB view.
+         */
+        BlobView() noexcept = default;
 
         /**
-         * Move constructs the blob object.
+         * Constructs a view of the num_bytes bytes starting at content.
          */
-        Blob(Blob&& other) noexcept : db(other.db), blob(other.blob)
+        BlobView(const void* content, size_t num_bytes) noexcept :
+            content(static_cast<const unsigned char*>(content)), num_bytes(num_bytes) {}
+
+        /**
+         * Returns a pointer to the first byte of the BLOB.
+         */
+        const unsigned char* data() const noexcept
         {
-            other.db = nullptr;
-            other.blob = nullptr;
+            return content;
         }
 
         /**
-         * Move assigns the blob object.
+         * Returns the number of bytes of the BLOB.
          */
-        Blob& operator=(Blob&& other) noexcept
+        size_t size() const noexcept
         {
-            using std::swap;
-            swap(db, other.db);
-            swap(blob, other.blob);
-            return *this;
+            return num_bytes;
         }
 
         /**
-         * Destroys the blob object by closing the blob handle.
+         * Returns true if the BLOB has no bytes.
          */
-        ~Blob()
+        bool empty() const noexcept
         {
-            close();
+            return num_bytes == 0;
         }
 
         /**
-         * Closes the blob handle if it is open.
+         * Returns an iterator to the first byte of the BLOB.
          */
-        void close() noexcept;
+        const_iterator begin() const noexcept
+        {
+            return content;
+        }
 
         /**
-         * Reads num_bytes bytes from the blob into buffer starting at
-         * blob_offset.
+         * Returns an iterator past the last byte of the BLOB.
+         */
+        const_iterator end() const noexcept
+        {
+            return content + num_bytes;
+        }
+
+        /**
+         * Returns the byte of the BLOB at index.
+         */
+        unsigned char operator[](size_t index) const noexcept
+        {
+            assert(index < num_bytes);
+            return content[index];
+        }
+
+        /**
+         * Compares the bytes of two BLOB views for equality.
+         */
+        friend bool operator==(BlobView lhs, BlobView rhs) noexcept
+        {
+            return lhs.num_bytes == rhs.num_bytes &&
+                   (lhs.num_bytes == 0 || std::memcmp(lhs.content, rhs.content, lhs.num_bytes) == 0);
+        }
+
+        /**
+         * Compares the bytes of two BLOB views for inequality.
+         */
+        friend bool operator!=(BlobView lhs, BlobView rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    private:
+        const unsigned char* content = nullptr;
+        size_t num_bytes = 0;
+    };
+
+    /**
+     * Models a blob for incremental I/O.
+     */
+    class Blob
+    {
+    public:
+        /// Flag to open the blob for reading only.
+        static constexpr int READ_ONLY = 0;
+        /// Flag to open the blob for both reading and writing.
+        static constexpr int READ_WRITE = 1;
+
+        Blob() = delete;
+        Blob(const Blob& other) = delete;
+        void operator=(const Blob& other) = delete;
+
+        /**
+         * Move constructs the blob object.
+         */
+        Blob(Blob&& other) noexcept : db(other.db), blob(other.blob)
+        {
+            other.db = nullptr;
+            other.blob = nullptr;
+        }
+
+        /**
+         * Move assigns the blob object.
+         */
+        Blob& operator=(Blob&& other) noexcept
+        {
+            using std::swap;
+            swap(db, other.db);
+            swap(blob, other.blob);
+            return *this;
+        }
+
+        /**
+         * Destroys the blob object by closing the blob handle.
+         */
+        ~Blob()
+        {
+            close();
+        }
+
+        /**
+         * Closes the blob handle if it is open.
+         */
+        void close() noexcept;
+
+        /**
+         * Reads num_bytes bytes from the blob into buffer starting at
+         * blob_offset.
          */
         void read(void* buffer, size_t num_bytes, size_t blob_offset);
 
@@ -433,10 +1181,11 @@ namespace sqlitemm
         /**
          * Move constructs the named parameter.
          */
-        Parameter(Parameter&& other) noexcept : stmt(other.stmt), index(other.index)
+        Parameter(Parameter&& other) noexcept : stmt(other.stmt), index(other.index), owned(other.owned)
         {
             other.stmt = nullptr;
             other.index = 0;
+            other.owned = nullptr;
         }
 
         /**
@@ -527,8 +1276,10 @@ namespace sqlitemm
         void operator=(const std::string& value);
 
         /**
-         * Binds a copy of the content of value and its length to the named
-         * parameter.
+         * Moves value into the prepared statement and binds its content and
+         * length to the named parameter, without copying. The prepared
+         * statement owns value until the parameter is bound again, the
+         * bindings are cleared, or the prepared statement is finalized.
          */
         void operator=(std::string&& value);
 
@@ -539,11 +1290,29 @@ namespace sqlitemm
         void operator=(const std::u16string& value);
 
         /**
-         * Binds a copy of the content of value and its length to the named
-         * parameter.
+         * Moves value into the prepared statement and binds its content and
+         * length to the named parameter, without copying. The prepared
+         * statement owns value until the parameter is bound again, the
+         * bindings are cleared, or the prepared statement is finalized.
          */
         void operator=(std::u16string&& value);
 
+        /**
+         * Binds the content of value and its length to the named parameter,
+         * without copying. The viewed text must remain valid until the
+         * parameter is bound again, the bindings are cleared, or the prepared
+         * statement is finalized.
+         */
+        void operator=(std::string_view value);
+
+        /**
+         * Binds the bytes viewed by value as a BLOB to the named parameter,
+         * without copying. The viewed bytes must remain valid until the
+         * parameter is bound again, the bindings are cleared, or the prepared
+         * statement is finalized.
+         */
+        void operator=(BlobView value);
+
         /**
          * Binds the content of value and its null-terminated length to the
          * named parameter, without copying.
@@ -588,13 +1357,48 @@ namespace sqlitemm
             }
         }
     private:
+        // text moved into the prepared statement by binding it to a parameter
+        struct OwnedText
+        {
+            std::string text;
+            std::u16string text16;
+
+            void clear() noexcept
+            {
+                text = std::string();
+                text16 = std::u16string();
+            }
+        };
+
         sqlite3_stmt* stmt; // prepared statement handle
         int index;          // index of the named parameter in the prepared statement
+        OwnedText* owned;   // storage for text moved into the prepared statement for this parameter
 
-        Parameter(sqlite3_stmt* stmt, const char* name);
+        Parameter(sqlite3_stmt* stmt, int index, OwnedText* owned) noexcept : stmt(stmt), index(index), owned(owned) {}
         friend class Statement;
     };
 
+    /**
+     * Counters reported by Statement::execute_many().
+     */
+    struct BatchStats
+    {
+        /// Number of rows that were executed.
+        size_t rows = 0;
+        /// Number of transactions that were committed.
+        size_t commits = 0;
+        /// Number of seconds taken to execute the rows.
+        double seconds = 0.0;
+
+        /**
+         * Returns the number of rows executed per second.
+         */
+        double rows_per_second() const noexcept
+        {
+            return seconds > 0.0 ? rows / seconds : 0.0;
+        }
+    };
+
     /**
      * Represents a prepared statement.
      */
@@ -608,7 +1412,7 @@ namespace sqlitemm
         /**
          * Move constructs the prepared statement.
          */
-        Statement(Statement&& other) noexcept : stmt_ptr(std::move(other.stmt_ptr)), parameter_index(other.parameter_index) {}
+        Statement(Statement&& other) noexcept;
 
         /**
          * Move assigns the prepared statement.
@@ -617,7 +1421,7 @@ namespace sqlitemm
 
         /**
          * Destroys the prepared statement by finalizing it if it has not been
-         * finalized.
+         * finalized, or by returning it to the statement cache it came from.
          */
         ~Statement()
         {
@@ -629,18 +1433,139 @@ namespace sqlitemm
          */
         void execute();
 
+        /**
+         * Executes the prepared statement without returning a result set,
+         * returning the status instead of throwing an exception on error.
+         */
+        Status try_execute() noexcept;
+
         /**
          * Executes the prepared statement, returning the corresponding
          * result set as a Result object.
          */
         Result execute_query(bool strict_typing = false);
 
+        /**
+         * Executes the prepared statement once for each row in rows, which
+         * may be any range, by invoking binder with this prepared statement
+         * and the row to bind the parameters, then executing and resetting
+         * the prepared statement.
+         *
+         * If commit_every is greater than 0 and the database connection is
+         * not already in a transaction, the rows are executed in
+         * transactions that are committed every commit_every rows and after
+         * the last row. If an exception is thrown, only the rows executed
+         * since the last commit are rolled back. Within an existing
+         * transaction, committing is left to the caller.
+         *
+         * Returns the number of rows executed, the number of transactions
+         * committed, and the time taken.
+         */
+        template<typename Range, typename Binder, typename = std::enable_if_t<
+            std::is_invocable_v<Binder&, Statement&, decltype(*std::begin(std::declval<const Range&>()))>
+        >>
+        BatchStats execute_many(const Range& rows, Binder binder, size_t commit_every = 0)
+        {
+            Batch batch(*this, commit_every);
+            for (const auto& row : rows)
+            {
+                binder(*this, row);
+                batch.execute_row();
+            }
+            return batch.finish();
+        }
+
+        /**
+         * Executes the prepared statement once for each row in rows, which
+         * may be any range of std::tuple, std::pair or std::array, by binding
+         * the elements of the row to the parameters in sequence, then
+         * executing and resetting the prepared statement.
+         *
+         * Transactions are handled as for execute_many() with a binder.
+         */
+        template<typename Range>
+        BatchStats execute_many(const Range& rows, size_t commit_every = 0)
+        {
+            return execute_many(rows, [](Statement& statement, const auto& row) { statement.bind(row); }, commit_every);
+        }
+
+        /**
+         * Binds args to the parameters of the prepared statement in sequence,
+         * starting from the first parameter, then positions the current
+         * parameter after the last of them.
+         *
+         * The conversion of each argument to a sqlite3_bind_* call is resolved
+         * at compile time for the types that can be bound through
+         * operator<<, with the same lifetime requirements. A single
+         * std::tuple, std::pair or std::array argument is unpacked, so a row
+         * can be bound directly.
+         *
+         * Throws sqlitemm::Error with SQLITE_RANGE if the number of arguments
+         * is not the number of parameters of the prepared statement.
+         */
+        template<typename... Args>
+        Statement& bind(Args&&... args)
+        {
+            if constexpr (sizeof...(Args) == 1 && (is_tuple_like<std::decay_t<Args>>::value && ...))
+            {
+                return std::apply([this](auto&&... values) -> Statement& {
+                    return bind(std::forward<decltype(values)>(values)...);
+                }, std::forward<Args>(args)...);
+            }
+            else
+            {
+                assert(stmt);
+                check_parameter_count(static_cast<int>(sizeof...(Args)));
+                int index = 0;
+                int result_code = SQLITE_OK;
+                // stops binding at the first error
+                static_cast<void>((((result_code = bind_value(++index, std::forward<Args>(args))) == SQLITE_OK) && ...));
+                if (result_code != SQLITE_OK)
+                {
+                    throw_bind_error(result_code);
+                }
+                parameter_index = static_cast<int>(sizeof...(Args)) + 1;
+                return *this;
+            }
+        }
+
+        /**
+         * Resets the prepared statement, binds args as for bind(), then
+         * executes the prepared statement without returning a result set.
+         *
+         * Unlike reset(), the error of a previous execution is not thrown.
+         */
+        template<typename... Args, typename = std::enable_if_t<(sizeof...(Args) > 0)>>
+        void execute(Args&&... args)
+        {
+            try_reset();
+            bind(std::forward<Args>(args)...);
+            execute();
+        }
+
+        /**
+         * Resets the prepared statement, binds args as for bind(), then
+         * executes the prepared statement and returns its result set.
+         *
+         * Unlike reset(), the error of a previous execution is not thrown.
+         */
+        template<typename... Args>
+        Result query(Args&&... args);
+
         /**
          * Resets the prepared statement for future execution.
          * If clear_bindings is true, the parameter bindings will also be cleared.
          */
         void reset(bool clear_bindings = false);
 
+        /**
+         * Resets the prepared statement for future execution, returning the
+         * status instead of throwing an exception on error. As with reset(),
+         * the status is that of the most recent step if it failed. If
+         * clear_bindings is true, the parameter bindings will also be cleared.
+         */
+        Status try_reset(bool clear_bindings = false) noexcept;
+
         /**
          * Clears the existing parameter bindings.
          */
@@ -648,7 +1573,9 @@ namespace sqlitemm
 
         /**
          * Finalizes the prepared statement.
-         * This effectively destroys the prepared statement.
+         * This effectively destroys the prepared statement, unless it was
+         * obtained from the statement cache, in which case it is reset with
+         * its bindings cleared and returned to the statement cache.
          */
         bool finalize() noexcept;
 
@@ -765,8 +1692,11 @@ namespace sqlitemm
         Statement& operator<<(const std::string& value);
 
         /**
-         * Binds a copy of the content of value and its length to the current
-         * parameter, then advances to the next parameter.
+         * Moves value into the prepared statement and binds its content and
+         * length to the current parameter, without copying, then advances to
+         * the next parameter. The prepared statement owns value until the
+         * parameter is bound again, the bindings are cleared, or the prepared
+         * statement is finalized.
          * Returns a reference to this prepared statement object.
          */
         Statement& operator<<(std::string&& value);
@@ -779,12 +1709,33 @@ namespace sqlitemm
         Statement& operator<<(const std::u16string& value);
 
         /**
-         * Binds a copy of the content of value and its length to the current
-         * parameter, then advances to the next parameter.
+         * Moves value into the prepared statement and binds its content and
+         * length to the current parameter, without copying, then advances to
+         * the next parameter. The prepared statement owns value until the
+         * parameter is bound again, the bindings are cleared, or the prepared
+         * statement is finalized.
          * Returns a reference to this prepared statement object.
          */
         Statement& operator<<(std::u16string&& value);
 
+        /**
+         * Binds the content of value and its length to the current parameter,
+         * without copying, then advances to the next parameter. The viewed
+         * text must remain valid until the parameter is bound again, the
+         * bindings are cleared, or the prepared statement is finalized.
+         * Returns a reference to this prepared statement object.
+         */
+        Statement& operator<<(std::string_view value);
+
+        /**
+         * Binds the bytes viewed by value as a BLOB to the current parameter,
+         * without copying, then advances to the next parameter. The viewed
+         * bytes must remain valid until the parameter is bound again, the
+         * bindings are cleared, or the prepared statement is finalized.
+         * Returns a reference to this prepared statement object.
+         */
+        Statement& operator<<(BlobView value);
+
         /**
          * Binds the content of value and its null-terminated length to the
          * current parameter, without copying, then advances to the next
@@ -841,7 +1792,7 @@ namespace sqlitemm
          */
         Parameter operator[](const char* name)
         {
-            return Parameter(*stmt_ptr, name);
+            return parameter(name);
         }
 
         /**
@@ -849,15 +1800,165 @@ namespace sqlitemm
          */
         Parameter operator[](const std::string& name)
         {
-            return (*this)[name.c_str()];
+            return parameter(name);
         }
+
+        /**
+         * Returns the named parameter for binding by name.
+         *
+         * The name to index mapping of the prepared statement's parameters is
+         * built on the first lookup by name and retained for the lifetime of
+         * the prepared statement, so subsequent lookups do not scan the
+         * parameter names. The returned parameter may be stored and bound to
+         * repeatedly without any further lookup, provided that it does not
+         * outlive the prepared statement.
+         *
+         * Throws sqlitemm::Error with SQLITE_RANGE if there is no parameter
+         * with the given name.
+         */
+        Parameter parameter(std::string_view name);
     private:
-        std::shared_ptr<sqlite3_stmt*> stmt_ptr; // prepared statement handle
-        int parameter_index = 1;                 // index of current parameter for binding
+        sqlite3_stmt* stmt = nullptr;          // prepared statement handle
+        StatementRegistry* registry = nullptr; // registry that the statement is linked into, if any
+        Statement* prev = nullptr;             // previous statement in the registry or statement cache
+        Statement* next = nullptr;             // next statement in the registry or statement cache
+        bool cached = false;                   // true if the statement is returned to the statement cache
+        std::string cache_key;                 // SQL text that the statement cache looks the statement up by
+        int parameter_index = 1;               // index of current parameter for binding
+        // named parameters sorted by name, built on the first lookup by name
+        std::vector<std::pair<std::string_view, int>> parameter_indices;
+        // text moved in by binding, per parameter in index order, sized on first use and then never
+        // resized so that parameters can refer to it, and moved along with the statement
+        std::vector<Parameter::OwnedText> owned_text;
+
+        // transaction and timing state of an execute_many() call
+        class Batch
+        {
+        public:
+            Batch(Statement& statement, size_t commit_every);
+            Batch(const Batch& other) = delete;
+            void operator=(const Batch& other) = delete;
+            ~Batch();
+
+            void execute_row();
+            BatchStats finish();
+        private:
+            Statement& statement;
+            size_t commit_every;         // number of rows per transaction, or 0
+            bool in_transaction = false; // true if a transaction begun by the batch is uncommitted
+            long long start_time;        // steady clock time in nanoseconds when the batch began
+            BatchStats stats;
+        };
+
+        Statement(sqlite3_stmt* stmt, StatementRegistry* registry) noexcept;
+
+        // returns the storage for text moved in for the parameter at index, or nullptr if out of range
+        Parameter::OwnedText* owned_text_for(int index);
+        void clear_owned_text() noexcept;
+
+        template<typename T, typename = void>
+        struct is_tuple_like : std::false_type {};
 
-        explicit Statement(std::shared_ptr<sqlite3_stmt*> stmt_ptr) : stmt_ptr(stmt_ptr) {}
+        template<typename T>
+        struct is_tuple_like<T, std::void_t<decltype(std::tuple_size<T>::value)>> : std::true_type {};
+
+        // throws sqlitemm::Error with SQLITE_RANGE unless the prepared statement has num_args parameters
+        void check_parameter_count(int num_args) const;
+        void throw_bind_error(int result_code) const;
+
+        template<typename T>
+        int bind_value(int index, T&& value)
+        {
+            using U = std::decay_t<T>;
+            if constexpr (detail::is_optional<U>::value)
+            {
+                return value ? bind_value(index, *std::forward<T>(value)) : sqlite3_bind_null(stmt, index);
+            }
+            else if constexpr (std::is_same_v<U, std::nullptr_t>)
+            {
+                return sqlite3_bind_null(stmt, index);
+            }
+            else if constexpr (std::is_same_v<U, bool>)
+            {
+                return sqlite3_bind_int(stmt, index, value ? 1 : 0);
+            }
+            else if constexpr (std::is_integral_v<U> && (sizeof(U) < sizeof(int) ||
+                                                         (std::is_signed_v<U> && sizeof(U) == sizeof(int))))
+            {
+                return sqlite3_bind_int(stmt, index, static_cast<int>(value));
+            }
+            else if constexpr (std::is_integral_v<U>)
+            {
+                return sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64>(value));
+            }
+            else if constexpr (std::is_floating_point_v<U>)
+            {
+                return sqlite3_bind_double(stmt, index, static_cast<double>(value));
+            }
+            else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+            {
+                return sqlite3_bind_text(stmt, index, value, -1, SQLITE_STATIC);
+            }
+            else if constexpr (std::is_same_v<U, std::string> && !std::is_lvalue_reference_v<T>)
+            {
+                auto owned = owned_text_for(index);
+                if (!owned)
+                {
+                    return SQLITE_RANGE;
+                }
+                owned->text = std::move(value);
+                return bind_value(index, std::string_view(owned->text));
+            }
+            else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+            {
+                // a null pointer would bind NULL rather than empty text
+                return sqlite3_bind_text64(
+                    stmt, index, value.data() ? value.data() : "", value.size(), SQLITE_STATIC, SQLITE_UTF8
+                );
+            }
+            else if constexpr (std::is_same_v<U, std::u16string> && !std::is_lvalue_reference_v<T>)
+            {
+                auto owned = owned_text_for(index);
+                if (!owned)
+                {
+                    return SQLITE_RANGE;
+                }
+                owned->text16 = std::move(value);
+                return bind_value(index, static_cast<const std::u16string&>(owned->text16));
+            }
+            else if constexpr (std::is_same_v<U, std::u16string>)
+            {
+                return sqlite3_bind_text16(
+                    stmt, index, value.c_str(), static_cast<int>(value.size() * sizeof(char16_t)), SQLITE_STATIC
+                );
+            }
+            else if constexpr (std::is_same_v<U, BlobView>)
+            {
+                // a null pointer would bind NULL rather than an empty BLOB
+                return value.data() ? sqlite3_bind_blob64(stmt, index, value.data(), value.size(), SQLITE_STATIC)
+                                    : sqlite3_bind_zeroblob(stmt, index, 0);
+            }
+            else if constexpr (std::is_same_v<U, TextValue>)
+            {
+                return sqlite3_bind_text(stmt, index, value.content, value.num_bytes, value.destructor);
+            }
+            else if constexpr (std::is_same_v<U, BlobValue>)
+            {
+                return sqlite3_bind_blob64(stmt, index, value.content, value.num_bytes, value.destructor);
+            }
+            else if constexpr (std::is_same_v<U, ZeroBlob>)
+            {
+                return sqlite3_bind_zeroblob64(stmt, index, value.num_bytes);
+            }
+            else
+            {
+                static_assert(!std::is_same_v<U, U>, "unsupported parameter type");
+            }
+        }
 
         friend Statement Connection::prepare(const std::string& sql);
+        friend class Script;
+        friend class StatementRegistry;
     };
 
     /**
@@ -948,6 +2049,27 @@ namespace sqlitemm
          */
         operator std::u16string() const;
 
+        /**
+         * Returns a view of the result field as UTF-8 encoded text without
+         * copying it.
+         *
+         * The view is only valid until the next step() of the result set,
+         * or until the field is converted to a different type. If
+         * SQLITEMM_DEBUG_VIEWS is defined when compiling both sqlitemm.cpp
+         * and the code that uses it, the view instead refers to a copy of
+         * the field that is overwritten with 0xDD bytes by the next step()
+         * so that use of a stale view is apparent.
+         */
+        operator std::string_view() const;
+
+        /**
+         * Returns a view of the result field as a BLOB without copying it.
+         *
+         * The view has the same validity as the std::string_view
+         * conversion.
+         */
+        operator BlobView() const;
+
         /**
          * Returns the result field as a std::optional<T>.
          */
@@ -955,13 +2077,33 @@ namespace sqlitemm
         std::optional<T> to_optional() const
         {
             std::optional<T> result;
-            if (column_type != SQLITE_NULL)
+            if (type() != SQLITE_NULL)
             {
                 result.emplace(*this);
             }
             return result;
         }
 
+        /**
+         * Returns the SQLite fundamental type of the result field, one of
+         * SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT, SQLITE_BLOB or
+         * SQLITE_NULL.
+         *
+         * The type is only retrieved from SQLite when it is first needed,
+         * i.e., by this function, by to_optional(), or by a conversion with
+         * strict typing, and is then retained. As in SQLite, the type is only
+         * meaningful if it is retrieved before the field is converted to
+         * another type.
+         */
+        int type() const noexcept
+        {
+            if (column_type == unknown_column_type)
+            {
+                column_type = sqlite3_column_type(stmt, index);
+            }
+            return column_type;
+        }
+
         /**
          * Reads the field as UTF-8 encoded text, done by invoking the
          * function object argument with two arguments:
@@ -971,7 +2113,8 @@ namespace sqlitemm
          *
          * The function object is expected to copy the string.
          */
-        void as_text(std::function<void(const unsigned char*, int)> retrieval_func) const
+        template<typename RetrievalFunc>
+        void as_text(RetrievalFunc&& retrieval_func) const
         {
             auto value = sqlite3_column_text(stmt, index);
             retrieval_func(value, sqlite3_column_bytes(stmt, index));
@@ -986,7 +2129,8 @@ namespace sqlitemm
          *
          * The function object is expected to copy the string.
          */
-        void as_text16(std::function<void(const void*, int)> retrieval_func) const
+        template<typename RetrievalFunc>
+        void as_text16(RetrievalFunc&& retrieval_func) const
         {
             auto value = sqlite3_column_text16(stmt, index);
             retrieval_func(value, sqlite3_column_bytes16(stmt, index));
@@ -1000,80 +2144,397 @@ namespace sqlitemm
          *
          * The function object is expected to copy the bytes of the BLOB.
          */
-        void as_blob(std::function<void(const void*, int)> retrieval_func) const
+        template<typename RetrievalFunc>
+        void as_blob(RetrievalFunc&& retrieval_func) const
         {
             auto value = sqlite3_column_blob(stmt, index);
             retrieval_func(value, sqlite3_column_bytes(stmt, index));
         }
     private:
+        static constexpr int unknown_column_type = 0; // none of the SQLite fundamental types
+
+        const Result* result;
         sqlite3_stmt* stmt;
         int index;
-        int column_type;
+        mutable int column_type = unknown_column_type; // retrieved on first use
         bool strict_typing;
 
-        ResultField(sqlite3_stmt* stmt, int index, bool strict_typing) noexcept :
-            stmt(stmt), index(index), strict_typing(strict_typing)
+        ResultField(const Result* result, sqlite3_stmt* stmt, int index, bool strict_typing) noexcept :
+            result(result), stmt(stmt), index(index), strict_typing(strict_typing) {}
+
+        // throws TypeError if strict typing is enabled and the field is not of the expected column type
+        void expect_column_type(int expected_column_type) const
         {
-            column_type = sqlite3_column_type(stmt, index);
+            if (strict_typing)
+            {
+                check_column_type(expected_column_type);
+            }
         }
 
+        void check_column_type(int expected_column_type) const;
+
         friend class Result;
     };
 
     /**
-     * Models a result set, and a result row thereof, from executing a query
-     * through a prepared statement.
+     * Describes a column of a result set.
+     *
+     * The origin database, table and column names are only available if
+     * SQLite was compiled with SQLITE_ENABLE_COLUMN_METADATA, and only for
+     * columns that are taken directly from a table column. Otherwise they are
+     * empty, as is the declared type for columns that are expressions.
      */
-    class Result
+    struct ColumnInfo
     {
-    public:
-        Result() = delete;
-        Result(const Result& other) = delete;
-        void operator=(const Result& other) = delete;
-
-        /**
-         * Move constructs the result set.
-         */
-        Result(Result&& other) noexcept : stmt(other.stmt), counter(other.counter), column_count(other.column_count)
-        {
-            other.stmt = nullptr;
-            other.counter = 0;
-            other.column_count = 0;
-        }
+        /// Name of the column in the result set, e.g., as given by AS.
+        std::string name;
+        /// Declared type of the table column that the column is taken from.
+        std::string declared_type;
+        /// Name of the database that the column is taken from, e.g., "main".
+        std::string database_name;
+        /// Name of the table that the column is taken from.
+        std::string table_name;
+        /// Name of the table column that the column is taken from.
+        std::string origin_name;
+    };
 
+    /**
+     * Models a batch of result rows stored column by column in contiguous
+     * typed buffers, as filled by Result::fetch_columns().
+     *
+     * Each column has a single storage type: SQLITE_INTEGER values are
+     * stored as std::int64_t, SQLITE_FLOAT values as double, and SQLITE_TEXT
+     * and SQLITE_BLOB values as consecutive bytes in an arena delimited by
+     * offsets. NULL fields are recorded in a bitmap and stored as zero or as
+     * an empty value. Buffers are retained when the batch is refilled, so a
+     * scan that reuses a batch only allocates while the buffers grow.
+     */
+    class ColumnBatch
+    {
+    public:
         /**
-         * Move assigns the result set.
+         * Models a column of a batch of result rows.
          */
-        Result& operator=(Result&& other) noexcept
+        class Column
         {
-            if (this != &other)
+        public:
+            /**
+             * Returns the storage type of the column: one of SQLITE_INTEGER,
+             * SQLITE_FLOAT, SQLITE_TEXT or SQLITE_BLOB.
+             */
+            int type() const noexcept
             {
-                stmt = other.stmt;
-                counter = other.counter;
-                column_count = other.column_count;
-                other.stmt = nullptr;
-                other.counter = 0;
-                other.column_count = 0;
+                return column_type;
             }
-            return *this;
-        }
 
-        /**
-         * Steps through the result set to advance to the next result row.
-         *
-         * Must be called before reading any fields in the result row.
-         * Returns true if there is a result row to read from.
-         */
-        bool step();
+            /**
+             * Returns true if the field of the column in the given row is
+             * NULL.
+             */
+            bool is_null(size_t row) const noexcept
+            {
+                return (null_bits[row / 64] >> (row % 64)) & 1;
+            }
+
+            /**
+             * Returns the bitmap of NULL fields, with the bit (row % 64) of
+             * element (row / 64) set if the field in the row is NULL.
+             */
+            const std::vector<std::uint64_t>& null_bitmap() const noexcept
+            {
+                return null_bits;
+            }
+
+            /**
+             * Returns the values of a column of SQLITE_INTEGER storage type,
+             * one per row.
+             */
+            const std::vector<std::int64_t>& integers() const noexcept
+            {
+                assert(column_type == SQLITE_INTEGER);
+                return integer_values;
+            }
+
+            /**
+             * Returns the values of a column of SQLITE_FLOAT storage type,
+             * one per row.
+             */
+            const std::vector<double>& reals() const noexcept
+            {
+                assert(column_type == SQLITE_FLOAT);
+                return real_values;
+            }
+
+            /**
+             * Returns the offsets into bytes() of a column of SQLITE_TEXT or
+             * SQLITE_BLOB storage type, such that the value of a row spans
+             * [offsets()[row], offsets()[row + 1]).
+             */
+            const std::vector<size_t>& offsets() const noexcept
+            {
+                assert(column_type == SQLITE_TEXT || column_type == SQLITE_BLOB);
+                return byte_offsets;
+            }
+
+            /**
+             * Returns the arena holding the values of a column of SQLITE_TEXT
+             * or SQLITE_BLOB storage type. Text is UTF-8 encoded and not
+             * null-terminated.
+             */
+            const std::vector<unsigned char>& bytes() const noexcept
+            {
+                assert(column_type == SQLITE_TEXT || column_type == SQLITE_BLOB);
+                return byte_values;
+            }
+
+            /**
+             * Returns a view of the value of a column of SQLITE_TEXT storage
+             * type in the given row, valid until the batch is refilled.
+             */
+            std::string_view text(size_t row) const noexcept
+            {
+                assert(column_type == SQLITE_TEXT);
+                return std::string_view(
+                    reinterpret_cast<const char*>(byte_values.data()) + byte_offsets[row],
+                    byte_offsets[row + 1] - byte_offsets[row]
+                );
+            }
+
+            /**
+             * Returns a view of the value of a column of SQLITE_BLOB storage
+             * type in the given row, valid until the batch is refilled.
+             */
+            BlobView blob(size_t row) const noexcept
+            {
+                assert(column_type == SQLITE_BLOB);
+                return BlobView(byte_values.data() + byte_offsets[row], byte_offsets[row + 1] - byte_offsets[row]);
+            }
+        private:
+            int column_type = SQLITE_BLOB;
+            std::vector<std::uint64_t> null_bits;
+            std::vector<std::int64_t> integer_values;
+            std::vector<double> real_values;
+            std::vector<size_t> byte_offsets;
+            std::vector<unsigned char> byte_values;
+
+            void clear(size_t batch_size);
+
+            friend class ColumnBatch;
+            friend class Result;
+        };
+
+        /**
+         * Constructs an empty batch whose column storage types are inferred
+         * when it is first filled: from the type of each field in the first
+         * row, or for a NULL field, from the affinity of the declared type of
+         * the column.
+         */
+        ColumnBatch() = default;
+
+        /**
+         * Constructs an empty batch with the given column storage types, each
+         * one of SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT or SQLITE_BLOB.
+         * Fields of other types are converted by SQLite, unless the result set
+         * was retrieved with strict typing.
+         */
+        explicit ColumnBatch(const std::vector<int>& column_types);
+
+        /**
+         * Returns the number of rows in the batch.
+         */
+        size_t size() const noexcept
+        {
+            return num_rows;
+        }
+
+        /**
+         * Returns true if the batch has no rows.
+         */
+        bool empty() const noexcept
+        {
+            return num_rows == 0;
+        }
+
+        /**
+         * Returns the number of columns in the batch.
+         */
+        size_t column_count() const noexcept
+        {
+            return columns.size();
+        }
+
+        /**
+         * Returns the column at index (starting from 0).
+         */
+        const Column& operator[](size_t index) const noexcept
+        {
+            assert(index < columns.size());
+            return columns[index];
+        }
+
+        /**
+         * Removes the rows of the batch. Inferred column storage types are
+         * forgotten along with their buffers, so the batch may then be reused
+         * for a different query.
+         */
+        void clear();
+    private:
+        std::vector<Column> columns;
+        size_t num_rows = 0;
+        bool inferred_types = true; // true if the column storage types are to be inferred
+
+        friend class Result;
+    };
+
+    /**
+     * Models a result set, and a result row thereof, from executing a query
+     * through a prepared statement.
+     */
+    class Result
+    {
+    public:
+        Result() = delete;
+        Result(const Result& other) = delete;
+        void operator=(const Result& other) = delete;
+
+        /**
+         * Move constructs the result set.
+         */
+        Result(Result&& other) noexcept :
+            stmt(other.stmt),
+            counter(other.counter),
+            num_columns(other.num_columns),
+            strict_typing(other.strict_typing),
+            exhausted(other.exhausted),
+#ifdef SQLITEMM_DEBUG_VIEWS
+            view_copies(std::move(other.view_copies)),
+            stale_view_copies(std::move(other.stale_view_copies)),
+#endif
+            column_info(std::move(other.column_info)),
+            column_indices(std::move(other.column_indices))
+        {
+            other.stmt = nullptr;
+            other.counter = 0;
+            other.num_columns = 0;
+        }
+
+        /**
+         * Move assigns the result set.
+         */
+        Result& operator=(Result&& other) noexcept
+        {
+            if (this != &other)
+            {
+                stmt = other.stmt;
+                counter = other.counter;
+                num_columns = other.num_columns;
+                strict_typing = other.strict_typing;
+                exhausted = other.exhausted;
+#ifdef SQLITEMM_DEBUG_VIEWS
+                view_copies = std::move(other.view_copies);
+                stale_view_copies = std::move(other.stale_view_copies);
+#endif
+                column_info = std::move(other.column_info);
+                column_indices = std::move(other.column_indices);
+                other.stmt = nullptr;
+                other.counter = 0;
+                other.num_columns = 0;
+            }
+            return *this;
+        }
+
+        /**
+         * Steps through the result set to advance to the next result row.
+         *
+         * Must be called before reading any fields in the result row.
+         * Returns true if there is a result row to read from.
+         */
+        bool step();
+
+        /**
+         * Steps through the result set to advance to the next result row,
+         * returning the status instead of throwing an exception on error.
+         *
+         * The status has a row to read from if has_row() is true, and is
+         * SQLITE_DONE if there are no more result rows.
+         */
+        Status try_step() noexcept;
 
         /**
          * Returns the result field corresponding to the index (starting from 0).
          */
         ResultField operator[](int index) const noexcept
         {
-            return ResultField(stmt, index, strict_typing);
+            return ResultField(this, stmt, index, strict_typing);
+        }
+
+        /**
+         * Returns the result field corresponding to the column name. If more
+         * than one column has the name, the leftmost such column is used.
+         *
+         * Throws sqlitemm::Error with SQLITE_RANGE if there is no column with
+         * the given name.
+         */
+        ResultField operator[](std::string_view name) const
+        {
+            return (*this)[column_index(name)];
+        }
+
+        /**
+         * Returns the index (starting from 0) of the column with the given
+         * name, as for operator[](std::string_view).
+         *
+         * The name to index mapping is built on the first lookup by name and
+         * retained for the lifetime of the result set.
+         */
+        int column_index(std::string_view name) const;
+
+        /**
+         * Returns the number of columns in the result set.
+         */
+        int column_count() const noexcept
+        {
+            return num_columns != 0 ? num_columns : sqlite3_column_count(stmt);
         }
 
+        /**
+         * Returns the metadata of the columns of the result set, in order.
+         *
+         * The metadata is retrieved from SQLite on the first call and
+         * retained for the lifetime of the result set, so it may be consulted
+         * once per query rather than once per row.
+         */
+        const std::vector<ColumnInfo>& columns() const;
+
+        /**
+         * Returns the metadata of the column at index (starting from 0).
+         */
+        const ColumnInfo& column(int index) const
+        {
+            assert(index >= 0 && index < column_count());
+            return columns()[index];
+        }
+
+        /**
+         * Steps through the result set to fill batch with up to batch_size
+         * rows, column by column, replacing its previous rows.
+         *
+         * The rows filled are those following the current row, if any, and
+         * the current field for stream operators is not meaningful after
+         * this. Returns the number of rows filled, which is less than
+         * batch_size only once the result set is exhausted, after which no
+         * more rows are filled. Hence the result set may be consumed with:
+         *
+         *     while (result.fetch_columns(batch, batch_size) > 0)
+         *
+         * Throws sqlitemm::Error with SQLITE_RANGE if batch has explicit
+         * column storage types for a different number of columns than the
+         * result set, or TypeError with strict typing if a field that is not
+         * NULL does not match the storage type of its column, in which case
+         * batch holds the rows filled before the row with that field.
+         */
+        size_t fetch_columns(ColumnBatch& batch, size_t batch_size);
+
         /**
          * Returns a result iterator for T that points to the first row of the
          * result set.
@@ -1213,6 +2674,24 @@ namespace sqlitemm
          */
         Result& operator>>(std::u16string& value);
 
+        /**
+         * Reads the current field in the result row as a view of UTF-8
+         * encoded text without copying it and stores it in value, then
+         * advances to the next field, if any.
+         * The view is only valid until the next step().
+         * Returns a reference to this Result object.
+         */
+        Result& operator>>(std::string_view& value);
+
+        /**
+         * Reads the current field in the result row as a view of a BLOB
+         * without copying it and stores it in value, then advances to the
+         * next field, if any.
+         * The view is only valid until the next step().
+         * Returns a reference to this Result object.
+         */
+        Result& operator>>(BlobView& value);
+
         /**
          * If the current field in the result row is NULL, this makes value an
          * empty std::optional<T>. Otherwise reads and converts the current
@@ -1248,10 +2727,11 @@ namespace sqlitemm
          *
          * The function object is expected to copy the string.
          */
-        void as_text(std::function<void(const unsigned char*, int)> retrieval_func)
+        template<typename RetrievalFunc>
+        void as_text(RetrievalFunc&& retrieval_func)
         {
-            assert(counter < column_count);
-            (*this)[counter++].as_text(retrieval_func);
+            assert(counter < num_columns);
+            (*this)[counter++].as_text(std::forward<RetrievalFunc>(retrieval_func));
         }
 
         /**
@@ -1265,10 +2745,11 @@ namespace sqlitemm
          *
          * The function object is expected to copy the string.
          */
-        void as_text16(std::function<void(const void*, int)> retrieval_func)
+        template<typename RetrievalFunc>
+        void as_text16(RetrievalFunc&& retrieval_func)
         {
-            assert(counter < column_count);
-            (*this)[counter++].as_text16(retrieval_func);
+            assert(counter < num_columns);
+            (*this)[counter++].as_text16(std::forward<RetrievalFunc>(retrieval_func));
         }
 
         /**
@@ -1281,22 +2762,193 @@ namespace sqlitemm
          *
          * The function object is expected to copy the bytes of the BLOB.
          */
-        void as_blob(std::function<void(const void*, int)> retrieval_func)
+        template<typename RetrievalFunc>
+        void as_blob(RetrievalFunc&& retrieval_func)
+        {
+            assert(counter < num_columns);
+            (*this)[counter++].as_blob(std::forward<RetrievalFunc>(retrieval_func));
+        }
+
+        /**
+         * Returns the fields of the current result row, starting from the
+         * first field, converted to the types Ts and stored in a std::tuple.
+         *
+         * The conversions follow the same rules as those of ResultField, but
+         * are resolved at compile time without creating ResultField objects.
+         * A field converted to std::optional<T> is empty if it is NULL.
+         * The type of each field is retrieved from SQLite at most once, and
+         * only if it is converted to std::optional<T> or strict typing is
+         * enabled.
+         *
+         * This does not advance the current field used by operator>>.
+         */
+        template<typename... Ts>
+        std::tuple<Ts...> row() const
         {
-            assert(counter < column_count);
-            (*this)[counter++].as_blob(retrieval_func);
+            assert(static_cast<int>(sizeof...(Ts)) <= num_columns);
+            return decode_row<std::tuple<Ts...>>(std::index_sequence_for<Ts...>());
+        }
+
+        /**
+         * Returns the fields of the current result row as an object of type
+         * T, which must be default constructible, by assigning the fields in
+         * sequence, starting from the first field, to the given data members.
+         *
+         * The conversions are resolved at compile time as for row().
+         */
+        template<typename T, typename... Members>
+        T row_as(Members T::*... members) const
+        {
+            assert(static_cast<int>(sizeof...(Members)) <= num_columns);
+            T object{};
+            int index = 0;
+            ((object.*members = decode_field<Members>(index++)), ...);
+            return object;
+        }
+
+        /**
+         * Returns an input range over the remaining rows of the result set,
+         * each of which is decoded as by row<Ts...>(). Beginning the range
+         * steps to the first remaining row.
+         */
+        template<typename... Ts>
+        RowRange<TupleRowDecoder<Ts...>> rows()
+        {
+            return RowRange<TupleRowDecoder<Ts...>>(*this, TupleRowDecoder<Ts...>());
+        }
+
+        /**
+         * Returns an input range over the remaining rows of the result set,
+         * each of which is decoded as by row_as<T>(members...). Beginning the
+         * range steps to the first remaining row.
+         */
+        template<typename T, typename... Members>
+        RowRange<MemberRowDecoder<T, Members...>> as(Members T::*... members)
+        {
+            return RowRange<MemberRowDecoder<T, Members...>>(
+                *this, MemberRowDecoder<T, Members...>{std::make_tuple(members...)}
+            );
         }
     private:
         sqlite3_stmt* stmt;   // prepared statement handle
         int counter = 0;      // field counter for each result row
-        int column_count = 0; // number of columns in the result set
+        int num_columns = 0; // number of columns in the result set
         bool strict_typing = false; // true if SQLite automatic type conversions should be prevented
+        bool exhausted = false;     // true if a step() found no more result rows
+#ifdef SQLITEMM_DEBUG_VIEWS
+        // copies of fields in the current row that were returned as views
+        mutable std::vector<std::pair<std::unique_ptr<unsigned char[]>, size_t>> view_copies;
+        // poisoned copies of fields in the previous row that were returned as views
+        std::vector<std::pair<std::unique_ptr<unsigned char[]>, size_t>> stale_view_copies;
+#endif
+        mutable std::vector<ColumnInfo> column_info; // column metadata, retrieved on first use
+        // column names sorted by name, built on the first lookup by name
+        mutable std::vector<std::pair<std::string_view, int>> column_indices;
 
         explicit Result(sqlite3_stmt* stmt, bool strict_typing) : stmt(stmt), strict_typing(strict_typing) {}
 
+        // returns the field at index as a view of text or of a BLOB, valid until the next step()
+        std::string_view text_view(int index) const;
+        BlobView blob_view(int index) const;
+#ifdef SQLITEMM_DEBUG_VIEWS
+        const void* track_view(const void* value, size_t num_bytes) const;
+        void invalidate_views() noexcept;
+#endif
+
+        // throws TypeError if the field at index is not of the expected column type, retrieving the column
+        // type of the field if it is not already known
+        void check_column_type(int index, int expected_column_type, int column_type) const;
+
+        void expect_column_type(int index, int expected_column_type, int column_type) const
+        {
+            if (strict_typing)
+            {
+                check_column_type(index, expected_column_type, column_type);
+            }
+        }
+
+        // decodes the field at index, retrieving its column type at most once and only if needed; column_type
+        // is the column type of the field if already retrieved, otherwise 0
+        template<typename T>
+        T decode_field(int index, int column_type = 0) const
+        {
+            if constexpr (detail::is_optional<T>::value)
+            {
+                column_type = sqlite3_column_type(stmt, index);
+                if (column_type == SQLITE_NULL)
+                {
+                    return T();
+                }
+                return T(decode_field<typename T::value_type>(index, column_type));
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                expect_column_type(index, SQLITE_INTEGER, column_type);
+                return sqlite3_column_int(stmt, index) != 0;
+            }
+            else if constexpr (std::is_integral_v<T> && (sizeof(T) < sizeof(int) || std::is_same_v<T, int>))
+            {
+                expect_column_type(index, SQLITE_INTEGER, column_type);
+                return static_cast<T>(sqlite3_column_int(stmt, index));
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                expect_column_type(index, SQLITE_INTEGER, column_type);
+                return static_cast<T>(sqlite3_column_int64(stmt, index));
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                expect_column_type(index, SQLITE_FLOAT, column_type);
+                return static_cast<T>(sqlite3_column_double(stmt, index));
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                expect_column_type(index, SQLITE_TEXT, column_type);
+                auto value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, index));
+                return value ? std::string(value, sqlite3_column_bytes(stmt, index)) : std::string();
+            }
+            else if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                expect_column_type(index, SQLITE_TEXT, column_type);
+                return text_view(index);
+            }
+            else if constexpr (std::is_same_v<T, BlobView>)
+            {
+                expect_column_type(index, SQLITE_BLOB, column_type);
+                return blob_view(index);
+            }
+            else if constexpr (std::is_same_v<T, std::u16string>)
+            {
+                expect_column_type(index, SQLITE_TEXT, column_type);
+                auto value = static_cast<const char16_t*>(sqlite3_column_text16(stmt, index));
+                return value ? std::u16string(value, sqlite3_column_bytes16(stmt, index) / sizeof(char16_t))
+                             : std::u16string();
+            }
+            else
+            {
+                static_assert(!std::is_same_v<T, T>, "unsupported result field type");
+            }
+        }
+
+        template<typename Tuple, size_t... Is>
+        Tuple decode_row(std::index_sequence<Is...>) const
+        {
+            return Tuple{decode_field<std::tuple_element_t<Is, Tuple>>(static_cast<int>(Is))...};
+        }
+
         friend Result Statement::execute_query(bool strict_typing);
+        friend class ResultField;
+        friend class ResultWriter;
     };
 
+    template<typename... Args>
+    Result Statement::query(Args&&... args)
+    {
+        try_reset();
+        bind(std::forward<Args>(args)...);
+        return execute_query();
+    }
+
     /**
      * Input iterator to the rows of a result set.
      *
@@ -1395,6 +3047,150 @@ namespace sqlitemm
         retrieval_function_type retrieval_function = nullptr;
     };
 
+    /**
+     * Decodes the current result row into a std::tuple<Ts...> for RowRange.
+     */
+    template<typename... Ts>
+    struct TupleRowDecoder
+    {
+        /**
+         * Returns the current result row decoded by result.row<Ts...>().
+         */
+        std::tuple<Ts...> operator()(const Result& result) const
+        {
+            return result.row<Ts...>();
+        }
+    };
+
+    /**
+     * Decodes the current result row into an object of type T for RowRange
+     * by assigning the fields in sequence to the data members.
+     */
+    template<typename T, typename... Members>
+    struct MemberRowDecoder
+    {
+        /// Data members to assign the fields to, in sequence.
+        std::tuple<Members T::*...> members;
+
+        /**
+         * Returns the current result row decoded by result.row_as<T>(members...).
+         */
+        T operator()(const Result& result) const
+        {
+            return std::apply([&result](auto... member) { return result.row_as<T>(member...); }, members);
+        }
+    };
+
+    /**
+     * Input range over the remaining rows of a result set, with each row
+     * decoded by a function object of type Decoder.
+     *
+     * Unlike ResultIterator, the decoder is not type erased, so the decoding
+     * of each row can be inlined. The range must not outlive the result set.
+     */
+    template<typename Decoder>
+    class RowRange
+    {
+    public:
+        /// Type of a decoded row.
+        using value_type = std::invoke_result_t<const Decoder&, const Result&>;
+
+        /**
+         * Input iterator to the rows of the range.
+         */
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = RowRange::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type;
+
+            /**
+             * Constructs an end iterator.
+             */
+            iterator() = default;
+
+            /**
+             * Returns the decoded row that this iterator points to.
+             */
+            value_type operator*() const
+            {
+                return range->decoder(*range->result);
+            }
+
+            /**
+             * Pre-increments the iterator to step to the next row.
+             */
+            iterator& operator++()
+            {
+                if (!range->result->step())
+                {
+                    range = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * Post-increments the iterator to step to the next row.
+             */
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            /**
+             * Compares the iterator with another iterator for equality. Two
+             * iterators are equal if they point to the same range, or if they
+             * are both end iterators.
+             */
+            bool operator==(const iterator& other) const noexcept
+            {
+                return range == other.range;
+            }
+
+            /**
+             * Compares the iterator with another iterator for inequality.
+             */
+            bool operator!=(const iterator& other) const noexcept
+            {
+                return range != other.range;
+            }
+        private:
+            const RowRange* range = nullptr;
+
+            explicit iterator(const RowRange* range) : range(range) {}
+
+            friend class RowRange;
+        };
+
+        /**
+         * Constructs a range over the remaining rows of result.
+         */
+        RowRange(Result& result, Decoder decoder) : result(&result), decoder(std::move(decoder)) {}
+
+        /**
+         * Steps to the next row of the result set and returns an iterator to
+         * it, or an end iterator if there are no more rows.
+         */
+        iterator begin() const
+        {
+            return result->step() ? iterator(this) : iterator();
+        }
+
+        /**
+         * Returns an end iterator.
+         */
+        iterator end() const noexcept
+        {
+            return iterator();
+        }
+    private:
+        Result* result;
+        Decoder decoder;
+    };
+
     /**
      * Compares the iterator with another result iterator for inequality.
      * Two result iterators are not equal if they do not point to the same
@@ -1438,9 +3234,11 @@ namespace sqlitemm
         /**
          * Move constructs the transaction.
          */
-        Transaction(Transaction&& other) noexcept : db(other.db), committed(other.committed)
+        Transaction(Transaction&& other) noexcept :
+            db(other.db), registry(other.registry), mode(other.mode), committed(other.committed)
         {
             other.db = nullptr;
+            other.registry = nullptr;
             other.committed = false;
         }
 
@@ -1457,7 +3255,7 @@ namespace sqlitemm
         }
 
         /**
-         * Begins the transaction.
+         * Begins the transaction with the mode that it was created with.
          *
          * This should only be called to reuse a transaction object.
          */
@@ -1473,12 +3271,205 @@ namespace sqlitemm
          */
         void rollback() noexcept;
     private:
-        sqlite3* db;            // database connection handle
-        bool committed = false; // true if the transaction has been committed
+        sqlite3* db;                   // database connection handle
+        StatementRegistry* registry;   // holds the prepared transaction control statements
+        TransactionMode mode;          // locking behaviour when the transaction begins
+        bool committed = false;        // true if the transaction has been committed
+
+        Transaction(sqlite3* db, StatementRegistry* registry, TransactionMode mode);
+
+        friend Transaction Connection::begin_transaction(TransactionMode mode);
+    };
+
+    /**
+     * Models a savepoint within a database transaction, which allows the
+     * changes made since the savepoint began to be rolled back without
+     * rolling back the enclosing transaction.
+     *
+     * Savepoints may be nested, but must be released or rolled back in the
+     * reverse order that they were begun, as happens when they are destroyed
+     * in that order.
+     */
+    class Savepoint
+    {
+    public:
+        Savepoint() = delete;
+        Savepoint(const Savepoint& other) = delete;
+        void operator=(const Savepoint& other) = delete;
+        void operator=(Savepoint&& other) = delete;
+
+        /**
+         * Move constructs the savepoint.
+         */
+        Savepoint(Savepoint&& other) noexcept : db(other.db), registry(other.registry), active(other.active)
+        {
+            other.db = nullptr;
+            other.registry = nullptr;
+            other.active = false;
+        }
+
+        /**
+         * Destroys the savepoint by rolling back to it if it has not been
+         * released or rolled back.
+         */
+        ~Savepoint()
+        {
+            rollback();
+        }
+
+        /**
+         * Begins the savepoint.
+         *
+         * This should only be called to reuse a savepoint object that has
+         * been released or rolled back.
+         */
+        void begin();
+
+        /**
+         * Releases the savepoint, keeping the changes made since it began as
+         * part of the enclosing transaction, if any, or otherwise committing
+         * them.
+         */
+        void release();
+
+        /**
+         * Rolls back the changes made since the savepoint began and releases
+         * the savepoint, if it has not been released or rolled back.
+         */
+        void rollback() noexcept;
+    private:
+        sqlite3* db;                 // database connection handle
+        StatementRegistry* registry; // holds the prepared savepoint control statements
+        bool active = false;         // true if the savepoint has begun but not been released or rolled back
+
+        Savepoint(sqlite3* db, StatementRegistry* registry);
+
+        friend Savepoint Connection::begin_savepoint();
+    };
+
+    /**
+     * Models a script of SQL statements that are prepared and executed in
+     * sequence.
+     *
+     * Each statement is prepared from the remaining SQL text only when the
+     * script first reaches it, so that a statement may depend on the schema
+     * changes made by the statements before it, as with
+     * Connection::execute(). Prepared statements are kept for the lifetime of
+     * the script, so executing it again does not compile any SQL.
+     */
+    class Script
+    {
+    public:
+        Script() = delete;
+        Script(const Script& other) = delete;
+        void operator=(const Script& other) = delete;
+
+        /**
+         * Move constructs the script.
+         */
+        Script(Script&& other) noexcept = default;
+
+        /**
+         * Move assigns the script.
+         */
+        Script& operator=(Script&& other) noexcept = default;
+
+        /**
+         * Executes each statement of the script in sequence, stepping each of
+         * them through to completion with parameters left as they were bound.
+         */
+        void execute()
+        {
+            execute([](size_t, Statement&) {});
+        }
+
+        /**
+         * Executes each statement of the script in sequence as for execute(),
+         * but first resets it and invokes binder with the index of the
+         * statement within the script and the statement, so that its
+         * parameters can be bound.
+         */
+        template<typename Binder>
+        void execute(Binder binder)
+        {
+            for (size_t index = 0; index < statements.size() || prepare_next(); ++index)
+            {
+                Statement& statement = statements[index];
+                statement.try_reset();
+                binder(index, statement);
+                step_to_completion(statement);
+            }
+        }
+
+        /**
+         * Executes each statement of the script in sequence as for
+         * execute(binder), except that for each statement that returns result
+         * columns, reader is invoked with the index of the statement and its
+         * result set instead of stepping it through to completion. Rows that
+         * reader does not step through are discarded.
+         */
+        template<typename Binder, typename Reader>
+        void execute(Binder binder, Reader reader)
+        {
+            for (size_t index = 0; index < statements.size() || prepare_next(); ++index)
+            {
+                Statement& statement = statements[index];
+                statement.try_reset();
+                binder(index, statement);
+                if (sqlite3_column_count(statement.stmt) > 0)
+                {
+                    Result result = statement.execute_query();
+                    reader(index, result);
+                }
+                else
+                {
+                    step_to_completion(statement);
+                }
+            }
+        }
+
+        /**
+         * Prepares any statements of the script that it has not yet reached,
+         * so that errors in the SQL are reported without executing it.
+         *
+         * Since the statements are prepared before the statements before them
+         * are executed, this fails if they depend on schema changes that the
+         * script has not yet made.
+         */
+        void prepare_all();
+
+        /**
+         * Returns the number of statements of the script that have been
+         * prepared.
+         */
+        size_t size() const noexcept
+        {
+            return statements.size();
+        }
+
+        /**
+         * Returns the prepared statement at index, which must be less than
+         * size().
+         */
+        Statement& operator[](size_t index) noexcept
+        {
+            assert(index < statements.size());
+            return statements[index];
+        }
+    private:
+        sqlite3* db;                      // database connection handle
+        StatementRegistry* registry;      // registry of the statements of the database connection
+        std::string sql;                  // SQL text of the script
+        size_t prepared_length = 0;       // length of the prefix of sql that has been prepared
+        std::vector<Statement> statements;
 
-        explicit Transaction(sqlite3* db);
+        Script(sqlite3* db, StatementRegistry* registry, const std::string& sql);
 
-        friend Transaction Connection::begin_transaction();
+        // prepares the next statement from the unprepared SQL text, returning false if there are none left
+        bool prepare_next();
+        static void step_to_completion(Statement& statement);
+
+        friend Script Connection::prepare_script(const std::string& sql);
     };
 
     /**
@@ -1557,6 +3548,259 @@ namespace sqlitemm
     public:
         using TypeError::TypeError;
     };
+
+    template<typename F>
+    void Connection::create_function(const std::string& name, F f, int flags)
+    {
+        using argument_types = typename callable_traits<F>::argument_types;
+        constexpr int num_args = static_cast<int>(std::tuple_size_v<argument_types>);
+        FunctionUserData user_data(
+            std::make_unique<F>(std::move(f)).release(), [](void* callable) { delete static_cast<F*>(callable); }
+        );
+        register_function(name, num_args, flags, std::move(user_data), &call_scalar_function<F>, nullptr, nullptr);
+    }
+
+    template<typename State>
+    void Connection::create_aggregate(const std::string& name, int flags)
+    {
+        static_assert(std::is_default_constructible_v<State>, "aggregate state must be default constructible");
+        // SQLite only guarantees 8 byte alignment for the aggregate context
+        static_assert(alignof(State) <= 8, "aggregate state must not be over-aligned");
+        using argument_types = typename callable_traits<decltype(&State::step)>::argument_types;
+        constexpr int num_args = static_cast<int>(std::tuple_size_v<argument_types>);
+        register_function(
+            name, num_args, flags, FunctionUserData(nullptr, nullptr), nullptr, &step_aggregate<State>,
+            &finalize_aggregate<State>
+        );
+    }
+
+    template<typename T>
+    T Connection::function_argument(sqlite3_value* value)
+    {
+        if constexpr (detail::is_optional<T>::value)
+        {
+            if (sqlite3_value_type(value) == SQLITE_NULL)
+            {
+                return T();
+            }
+            return T(function_argument<typename T::value_type>(value));
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            return sqlite3_value_int(value) != 0;
+        }
+        else if constexpr (std::is_integral_v<T> && (sizeof(T) < sizeof(int) || std::is_same_v<T, int>))
+        {
+            return static_cast<T>(sqlite3_value_int(value));
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return static_cast<T>(sqlite3_value_int64(value));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return static_cast<T>(sqlite3_value_double(value));
+        }
+        else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+        {
+            auto text = reinterpret_cast<const char*>(sqlite3_value_text(value));
+            return text ? T(text, static_cast<size_t>(sqlite3_value_bytes(value))) : T();
+        }
+        else if constexpr (std::is_same_v<T, BlobView>)
+        {
+            auto content = sqlite3_value_blob(value);
+            return BlobView(content, content ? static_cast<size_t>(sqlite3_value_bytes(value)) : 0);
+        }
+        else if constexpr (std::is_same_v<T, sqlite3_value*>)
+        {
+            return value;
+        }
+        else
+        {
+            static_assert(!std::is_same_v<T, T>, "unsupported SQL function argument type");
+        }
+    }
+
+    template<typename T>
+    void Connection::set_function_result(sqlite3_context* context, T&& value)
+    {
+        using U = std::decay_t<T>;
+        if constexpr (detail::is_optional<U>::value)
+        {
+            if (value)
+            {
+                set_function_result(context, *std::forward<T>(value));
+            }
+            else
+            {
+                sqlite3_result_null(context);
+            }
+        }
+        else if constexpr (std::is_same_v<U, std::nullptr_t>)
+        {
+            sqlite3_result_null(context);
+        }
+        else if constexpr (std::is_same_v<U, bool>)
+        {
+            sqlite3_result_int(context, value ? 1 : 0);
+        }
+        else if constexpr (std::is_integral_v<U> && (sizeof(U) < sizeof(int) || std::is_same_v<U, int>))
+        {
+            sqlite3_result_int(context, value);
+        }
+        else if constexpr (std::is_integral_v<U>)
+        {
+            sqlite3_result_int64(context, static_cast<sqlite3_int64>(value));
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            sqlite3_result_double(context, static_cast<double>(value));
+        }
+        else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+        {
+            // a null pointer would make the result NULL rather than empty text
+            sqlite3_result_text64(
+                context, value.data() ? value.data() : "", value.size(), SQLITE_TRANSIENT, SQLITE_UTF8
+            );
+        }
+        else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+        {
+            sqlite3_result_text(context, value, -1, SQLITE_TRANSIENT);
+        }
+        else if constexpr (std::is_same_v<U, std::u16string>)
+        {
+            sqlite3_result_text16(
+                context, value.data(), static_cast<int>(value.size() * sizeof(char16_t)), SQLITE_TRANSIENT
+            );
+        }
+        else if constexpr (std::is_same_v<U, BlobView>)
+        {
+            if (value.data())
+            {
+                sqlite3_result_blob64(context, value.data(), value.size(), SQLITE_TRANSIENT);
+            }
+            else
+            {
+                sqlite3_result_zeroblob(context, 0);
+            }
+        }
+        else if constexpr (std::is_same_v<U, ZeroBlob>)
+        {
+            sqlite3_result_zeroblob64(context, value.num_bytes);
+        }
+        else
+        {
+            static_assert(!std::is_same_v<U, U>, "unsupported SQL function result type");
+        }
+    }
+
+    template<typename Args, typename F, size_t... Is>
+    void Connection::invoke_function(
+        sqlite3_context* context, F&& f, sqlite3_value** values, std::index_sequence<Is...>
+    )
+    {
+        using R = decltype(std::forward<F>(f)(function_argument<std::tuple_element_t<Is, Args>>(values[Is])...));
+        if constexpr (std::is_void_v<R>)
+        {
+            std::forward<F>(f)(function_argument<std::tuple_element_t<Is, Args>>(values[Is])...);
+            sqlite3_result_null(context);
+        }
+        else
+        {
+            set_function_result(
+                context, std::forward<F>(f)(function_argument<std::tuple_element_t<Is, Args>>(values[Is])...)
+            );
+        }
+    }
+
+    template<typename F>
+    void Connection::call_scalar_function(sqlite3_context* context, int, sqlite3_value** values) noexcept
+    {
+        using argument_types = typename callable_traits<F>::argument_types;
+        try
+        {
+            auto& f = *static_cast<F*>(sqlite3_user_data(context));
+            invoke_function<argument_types>(
+                context, f, values, std::make_index_sequence<std::tuple_size_v<argument_types>>()
+            );
+        }
+        catch (...)
+        {
+            set_function_error(context);
+        }
+    }
+
+    template<typename State>
+    void Connection::step_aggregate(sqlite3_context* context, int, sqlite3_value** values) noexcept
+    {
+        using argument_types = typename callable_traits<decltype(&State::step)>::argument_types;
+        auto storage = static_cast<AggregateStorage<State>*>(
+            sqlite3_aggregate_context(context, sizeof(AggregateStorage<State>))
+        );
+        if (!storage)
+        {
+            sqlite3_result_error_nomem(context);
+            return;
+        }
+
+        try
+        {
+            if (!storage->constructed)
+            {
+                new (storage->state) State();
+                storage->constructed = true;
+            }
+            auto& state = *std::launder(reinterpret_cast<State*>(storage->state));
+            invoke_function<argument_types>(
+                context,
+                [&state](auto&&... args) { state.step(std::forward<decltype(args)>(args)...); },
+                values,
+                std::make_index_sequence<std::tuple_size_v<argument_types>>()
+            );
+        }
+        catch (...)
+        {
+            set_function_error(context);
+        }
+    }
+
+    template<typename State>
+    void Connection::finalize_aggregate(sqlite3_context* context) noexcept
+    {
+        // a zero size does not allocate the aggregate context if there were no rows
+        auto storage = static_cast<AggregateStorage<State>*>(sqlite3_aggregate_context(context, 0));
+        if (storage && storage->constructed)
+        {
+            auto& state = *std::launder(reinterpret_cast<State*>(storage->state));
+            try
+            {
+                invoke_function<std::tuple<>>(
+                    context, [&state]() { return state.finalize(); }, nullptr, std::index_sequence<>()
+                );
+            }
+            catch (...)
+            {
+                set_function_error(context);
+            }
+            // SQLite calls the final function even if the statement is aborted, so this always runs
+            state.~State();
+            storage->constructed = false;
+        }
+        else
+        {
+            try
+            {
+                State state;
+                invoke_function<std::tuple<>>(
+                    context, [&state]() { return state.finalize(); }, nullptr, std::index_sequence<>()
+                );
+            }
+            catch (...)
+            {
+                set_function_error(context);
+            }
+        }
+    }
 }
 
 #endif
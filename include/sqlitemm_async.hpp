@@ -0,0 +1,298 @@
+#ifndef SQLITEMM_ASYNC_20250601_H_
+#define SQLITEMM_ASYNC_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm asynchronous connection header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Models a database connection that is owned by a dedicated worker
+     * thread, to which work is submitted from any thread without blocking.
+     *
+     * Submitted work is queued in a lock-free multiple producer, single
+     * consumer queue, and the worker runs queued work back to back in
+     * submission order, only going to sleep once the queue has stayed empty
+     * for a short spin. Submitting work does not take a lock unless the
+     * worker is asleep.
+     *
+     * Since only the worker thread uses the database connection, it is
+     * opened with SQLITE_OPEN_NOMUTEX by default. Work must not let the
+     * database connection, or statements or results from it, escape to other
+     * threads.
+     */
+    class AsyncConnection
+    {
+    public:
+        AsyncConnection(const AsyncConnection& other) = delete;
+        void operator=(const AsyncConnection& other) = delete;
+
+        /**
+         * Opens the database given by filename with the given flags and
+         * optional VFS module name, enables the statement cache with the given
+         * capacity for the SQL submitted through execute() and query(), and
+         * starts the worker thread.
+         *
+         * Throws sqlitemm::Error if the database cannot be opened.
+         */
+        explicit AsyncConnection(
+            const std::string& filename,
+            int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+            const std::string& vfs = std::string{},
+            size_t statement_cache_capacity = 16
+        );
+
+        /**
+         * Runs any work that is still queued, then stops the worker thread
+         * and closes the database connection.
+         *
+         * No work may be submitted once destruction has begun.
+         */
+        ~AsyncConnection();
+
+        /**
+         * Queues work, a callable taking a reference to the database
+         * connection, to be run on the worker thread.
+         *
+         * Returns a future for the return value of work, or for the exception
+         * that it threw.
+         */
+        template<typename F>
+        auto submit(F&& work) -> std::future<std::invoke_result_t<std::decay_t<F>&, Connection&>>
+        {
+            using R = std::invoke_result_t<std::decay_t<F>&, Connection&>;
+            std::promise<R> promise;
+            auto future = promise.get_future();
+            enqueue(new Task<PromiseTask<std::decay_t<F>, R>>(
+                PromiseTask<std::decay_t<F>, R>{std::forward<F>(work), std::move(promise)}
+            ));
+            return future;
+        }
+
+        /**
+         * Queues work, a callable taking a reference to the database
+         * connection, to be run on the worker thread, followed by on_complete
+         * on the worker thread.
+         *
+         * If work returns void, on_complete is called with a std::exception_ptr
+         * that holds the exception thrown by work, if any. Otherwise it is
+         * called with that std::exception_ptr and a std::optional holding the
+         * return value of work, or a copy of the object that it refers to,
+         * unless work threw. Exceptions thrown by on_complete are ignored.
+         */
+        template<typename F, typename Callback>
+        void submit(F&& work, Callback&& on_complete)
+        {
+            enqueue(new Task<CallbackTask<std::decay_t<F>, std::decay_t<Callback>>>(
+                CallbackTask<std::decay_t<F>, std::decay_t<Callback>>{
+                    std::forward<F>(work), std::forward<Callback>(on_complete)
+                }
+            ));
+        }
+
+        /**
+         * Queues the execution of the single SQL statement sql, with args
+         * bound to its parameters as by Statement::bind(), on the worker
+         * thread.
+         *
+         * The arguments are copied or moved into the queued work, so that a
+         * pointer argument such as a const char* must remain valid until the
+         * work has run.
+         *
+         * Returns a future for the number of rows modified, inserted or
+         * deleted by the statement.
+         */
+        template<typename... Args>
+        std::future<int> execute(std::string sql, Args&&... args)
+        {
+            return submit(
+                [sql = std::move(sql), values = std::make_tuple(std::forward<Args>(args)...)](Connection& conn) mutable {
+                    auto statement = conn.prepare_cached(sql);
+                    std::apply([&statement](auto&&... values) {
+                        statement.execute(std::move(values)...);
+                    }, std::move(values));
+                    return conn.changes();
+                }
+            );
+        }
+
+        /**
+         * Queues the query sql, with args bound to its parameters as by
+         * Statement::bind(), on the worker thread, decoding each result row as
+         * by Result::row<Ts...>(). The arguments are captured as for execute().
+         *
+         * Returns a future for the decoded rows. Since the rows outlive the
+         * result set, they cannot hold std::string_view or BlobView fields.
+         */
+        template<typename... Ts, typename... Args>
+        std::future<std::vector<std::tuple<Ts...>>> query(std::string sql, Args&&... args)
+        {
+            static_assert(((!std::is_same_v<Ts, std::string_view> && !std::is_same_v<Ts, BlobView>) && ...),
+                          "decoded rows must not hold views of the result set");
+            return submit(
+                [sql = std::move(sql), values = std::make_tuple(std::forward<Args>(args)...)](Connection& conn) mutable {
+                    auto statement = conn.prepare_cached(sql);
+                    auto result = std::apply([&statement](auto&&... values) {
+                        return statement.query(std::move(values)...);
+                    }, std::move(values));
+                    std::vector<std::tuple<Ts...>> rows;
+                    for (auto&& row : result.template rows<Ts...>())
+                    {
+                        rows.push_back(std::move(row));
+                    }
+                    return rows;
+                }
+            );
+        }
+    private:
+        // queued work, linked into the queue through next
+        struct Node
+        {
+            std::atomic<Node*> next{nullptr};
+
+            virtual ~Node() = default;
+            virtual void run(Connection& conn) noexcept = 0;
+        };
+
+        // placeholder node that keeps the queue non-empty
+        struct StubNode : Node
+        {
+            void run(Connection&) noexcept override {}
+        };
+
+        template<typename Work>
+        struct Task : Node
+        {
+            Work work;
+
+            explicit Task(Work&& work) : work(std::move(work)) {}
+
+            void run(Connection& conn) noexcept override
+            {
+                work(conn);
+            }
+        };
+
+        template<typename F, typename R>
+        struct PromiseTask
+        {
+            F work;
+            std::promise<R> promise;
+
+            void operator()(Connection& conn) noexcept
+            {
+                try
+                {
+                    if constexpr (std::is_void_v<R>)
+                    {
+                        work(conn);
+                        promise.set_value();
+                    }
+                    else
+                    {
+                        promise.set_value(work(conn));
+                    }
+                }
+                catch (...)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+            }
+        };
+
+        template<typename F, typename Callback>
+        struct CallbackTask
+        {
+            F work;
+            Callback on_complete;
+
+            void operator()(Connection& conn) noexcept
+            {
+                using R = std::invoke_result_t<F&, Connection&>;
+                try
+                {
+                    if constexpr (std::is_void_v<R>)
+                    {
+                        std::exception_ptr error;
+                        try
+                        {
+                            work(conn);
+                        }
+                        catch (...)
+                        {
+                            error = std::current_exception();
+                        }
+                        on_complete(error);
+                    }
+                    else
+                    {
+                        std::exception_ptr error;
+                        // a reference result is copied, since std::optional cannot hold a reference
+                        std::optional<std::decay_t<R>> value;
+                        try
+                        {
+                            value.emplace(work(conn));
+                        }
+                        catch (...)
+                        {
+                            error = std::current_exception();
+                        }
+                        on_complete(error, std::move(value));
+                    }
+                }
+                catch (...)
+                {
+                    // there is no one to report the exception to
+                }
+            }
+        };
+
+        Connection conn;
+        StubNode stub;
+        std::atomic<Node*> head{&stub}; // most recently queued node, updated by producers
+        Node* tail = &stub;              // oldest queued node, only accessed by the worker
+        std::atomic<bool> worker_sleeping{false};
+        std::atomic<bool> stopping{false};
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+        std::thread worker;
+
+        void enqueue(Node* node) noexcept;
+        Node* dequeue() noexcept;
+        bool queue_empty() const noexcept;
+        void run() noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef SQLITEMM_BACKUP_JOB_20250601_H_
+#define SQLITEMM_BACKUP_JOB_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm backup job header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Progress of a backup job as of its most recent step.
+     */
+    struct BackupProgress
+    {
+        /// Number of pages still to be copied.
+        int pages_remaining = 0;
+        /// Total number of pages in the source database.
+        int page_count = 0;
+    };
+
+    /**
+     * Outcome of a backup job that did not fail with an exception.
+     */
+    enum class BackupStatus
+    {
+        /// Every page was copied to the destination database.
+        Completed,
+        /// The backup job was cancelled before every page was copied.
+        Cancelled
+    };
+
+    /**
+     * Options controlling how a backup job steps through the source database.
+     *
+     * The job begins by copying min_pages_per_step pages per step, doubling
+     * that after each successful step up to max_pages_per_step, so that an
+     * idle source database is copied in large batches. When a step fails
+     * because the source database is busy or locked, the pages per step are
+     * reset to min_pages_per_step and the job backs off, doubling the backoff
+     * from min_backoff up to max_backoff for as long as the steps keep
+     * failing.
+     */
+    struct BackupJobOptions
+    {
+        /// Number of pages copied by the first step and after a busy step.
+        int min_pages_per_step = 8;
+        /// Largest number of pages copied by a single step.
+        int max_pages_per_step = 1024;
+        /// Pause after each successful step, to let writers to the source in.
+        std::chrono::milliseconds step_interval{0};
+        /// Pause after the first busy or locked step.
+        std::chrono::milliseconds min_backoff{5};
+        /// Longest pause after consecutive busy or locked steps.
+        std::chrono::milliseconds max_backoff{500};
+        /// Function called on the backup thread with the progress after each successful step.
+        std::function<void(const BackupProgress&)> progress_callback;
+    };
+
+    /**
+     * Models an online database backup that runs on a background thread.
+     *
+     * The source database connection may continue to be used while the
+     * backup job runs, provided that it was opened in serialized threading
+     * mode, i.e., not with SQLITE_OPEN_NOMUTEX. The destination database
+     * connection must not be used until the backup job finishes.
+     */
+    class BackupJob
+    {
+    public:
+        BackupJob(const BackupJob& other) = delete;
+        void operator=(const BackupJob& other) = delete;
+
+        /**
+         * Starts a backup job from the source database using the source
+         * database connection and database name to the destination database
+         * using the destination database connection and database name.
+         *
+         * Throws sqlitemm::Error if the backup cannot be started.
+         */
+        BackupJob(Connection& source, const std::string& source_database,
+                  Connection& destination, const std::string& destination_database,
+                  BackupJobOptions options = BackupJobOptions{});
+
+        /**
+         * Destroys the backup job, cancelling it if it has not finished and
+         * waiting for the backup thread to exit.
+         */
+        ~BackupJob();
+
+        /**
+         * Requests that the backup job stop before its next step. This does
+         * not wait for the backup thread to exit.
+         */
+        void cancel() noexcept;
+
+        /**
+         * Returns a future that becomes ready when the backup job finishes,
+         * holding its status, or the exception that caused it to fail.
+         */
+        std::shared_future<BackupStatus> result() const
+        {
+            return status;
+        }
+
+        /**
+         * Waits for the backup job to finish and returns its status.
+         *
+         * Rethrows the exception that caused the backup job to fail, if any.
+         */
+        BackupStatus wait()
+        {
+            return status.get();
+        }
+
+        /**
+         * Returns the progress of the backup job as of its most recent
+         * successful step.
+         */
+        BackupProgress progress() const noexcept
+        {
+            return BackupProgress{pages_remaining.load(), page_count.load()};
+        }
+    private:
+        Backup backup;
+        BackupJobOptions options;
+        std::atomic<int> pages_remaining{0};
+        std::atomic<int> page_count{0};
+        std::atomic<bool> cancelled{false};
+        std::mutex cancel_mutex;                // only used to interrupt pauses
+        std::condition_variable cancel_requested;
+        std::promise<BackupStatus> promise;
+        std::shared_future<BackupStatus> status;
+        std::thread thread;
+
+        void run() noexcept;
+        BackupStatus run_steps();
+        bool pause(std::chrono::milliseconds duration);
+    };
+}
+
+#endif
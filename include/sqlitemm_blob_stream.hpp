@@ -0,0 +1,175 @@
+#ifndef SQLITEMM_BLOB_STREAM_20250601_H_
+#define SQLITEMM_BLOB_STREAM_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm blob stream header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Default size in bytes of the buffer of a blob stream buffer.
+     */
+    constexpr size_t default_blob_stream_buffer_size = 64 * 1024;
+
+    /**
+     * Default size in bytes of the chunks copied by copy_to() and copy_from().
+     */
+    constexpr size_t default_blob_copy_chunk_size = 1024 * 1024;
+
+    /**
+     * Models a stream buffer that reads from and writes to a blob opened for
+     * incremental I/O, through an internal buffer of configurable size.
+     *
+     * Since the size of a blob cannot be changed through incremental I/O,
+     * writing past the end of the blob fails. Reads and writes of at least
+     * the buffer size bypass the internal buffer. The blob must outlive the
+     * stream buffer.
+     */
+    class BlobStreamBuf : public std::streambuf
+    {
+    public:
+        BlobStreamBuf(const BlobStreamBuf& other) = delete;
+        void operator=(const BlobStreamBuf& other) = delete;
+
+        /**
+         * Constructs a stream buffer positioned at the start of blob, with an
+         * internal buffer of buffer_size bytes.
+         */
+        explicit BlobStreamBuf(Blob& blob, size_t buffer_size = default_blob_stream_buffer_size);
+
+        /**
+         * Destroys the stream buffer, writing any buffered output to the blob.
+         * Errors from writing are ignored, so sync should be called first if
+         * they are to be handled.
+         */
+        ~BlobStreamBuf() override;
+
+        /**
+         * Writes any buffered output to the blob, then moves the blob to the
+         * given row of the same table and column, and positions the stream
+         * buffer at its start, reusing the blob handle and internal buffer.
+         */
+        void reopen(size_t row);
+    protected:
+        int_type underflow() override;
+        int_type overflow(int_type ch = traits_type::eof()) override;
+        int sync() override;
+        std::streamsize showmanyc() override;
+        std::streamsize xsgetn(char* s, std::streamsize count) override;
+        std::streamsize xsputn(const char* s, std::streamsize count) override;
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type target, std::ios_base::openmode which) override;
+    private:
+        Blob& blob;
+        std::unique_ptr<char[]> buffer;
+        size_t buffer_size;
+        size_t blob_size;    // cached size of the blob, which cannot change except through reopen()
+        size_t position = 0; // blob offset of the start of the get or put area, or of the stream if neither
+
+        size_t offset() const noexcept;
+        void flush_put_area();
+        void end_get_area() noexcept;
+    };
+
+    /**
+     * Models an input stream that reads from a blob.
+     */
+    class BlobIStream : public std::istream
+    {
+    public:
+        /**
+         * Constructs an input stream positioned at the start of blob, with an
+         * internal buffer of buffer_size bytes.
+         */
+        explicit BlobIStream(Blob& blob, size_t buffer_size = default_blob_stream_buffer_size) :
+            std::istream(nullptr), stream_buffer(blob, buffer_size)
+        {
+            rdbuf(&stream_buffer);
+        }
+
+        /**
+         * Moves the blob to the given row and positions the stream at its
+         * start, clearing the stream state.
+         */
+        void reopen(size_t row)
+        {
+            stream_buffer.reopen(row);
+            clear();
+        }
+    private:
+        BlobStreamBuf stream_buffer;
+    };
+
+    /**
+     * Models an output stream that writes to a blob.
+     */
+    class BlobOStream : public std::ostream
+    {
+    public:
+        /**
+         * Constructs an output stream positioned at the start of blob, with
+         * an internal buffer of buffer_size bytes.
+         */
+        explicit BlobOStream(Blob& blob, size_t buffer_size = default_blob_stream_buffer_size) :
+            std::ostream(nullptr), stream_buffer(blob, buffer_size)
+        {
+            rdbuf(&stream_buffer);
+        }
+
+        /**
+         * Writes any buffered output, then moves the blob to the given row and
+         * positions the stream at its start, clearing the stream state.
+         */
+        void reopen(size_t row)
+        {
+            stream_buffer.reopen(row);
+            clear();
+        }
+    private:
+        BlobStreamBuf stream_buffer;
+    };
+
+    /**
+     * Copies the content of blob to the file descriptor fd in chunks of
+     * chunk_size bytes read directly into a single chunk buffer.
+     *
+     * Returns the number of bytes copied. Throws sqlitemm::Error if the blob
+     * cannot be read, or std::system_error if fd cannot be written.
+     */
+    size_t copy_to(Blob& blob, int fd, size_t chunk_size = default_blob_copy_chunk_size);
+
+    /**
+     * Copies up to the size of blob bytes from the file descriptor fd to
+     * blob, starting from the start of the blob, in chunks of chunk_size
+     * bytes read directly into a single chunk buffer.
+     *
+     * Returns the number of bytes copied, which is less than the size of the
+     * blob only if the end of the file was reached. Throws sqlitemm::Error if
+     * the blob cannot be written, or std::system_error if fd cannot be read.
+     */
+    size_t copy_from(Blob& blob, int fd, size_t chunk_size = default_blob_copy_chunk_size);
+}
+
+#endif
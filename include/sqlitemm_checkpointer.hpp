@@ -0,0 +1,168 @@
+#ifndef SQLITEMM_CHECKPOINTER_20250601_H_
+#define SQLITEMM_CHECKPOINTER_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm checkpointer header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Report of a checkpoint run by a Checkpointer.
+     */
+    struct CheckpointReport
+    {
+        /// Mode of the checkpoint.
+        CheckpointMode mode = CheckpointMode::Passive;
+        /// Outcome of the checkpoint.
+        CheckpointResult result;
+    };
+
+    /**
+     * Cumulative counters of a Checkpointer.
+     */
+    struct CheckpointerStats
+    {
+        /// Number of checkpoints run, of any mode.
+        unsigned long long checkpoints = 0;
+        /// Number of checkpoints that could not be completed because of other connections.
+        unsigned long long busy_checkpoints = 0;
+        /// Total number of WAL frames copied back into the database, not
+        /// counting again the frames that an earlier checkpoint of the same
+        /// WAL reported.
+        unsigned long long checkpointed_frames = 0;
+        /// Number of frames in the WAL as of the most recent checkpoint.
+        int wal_frames = 0;
+    };
+
+    /**
+     * Options controlling when a Checkpointer runs checkpoints, by the number
+     * of frames in the WAL.
+     *
+     * A passive checkpoint is run once the WAL has at least
+     * passive_threshold_frames frames, and whenever interval elapses with
+     * frames in the WAL. If the WAL still has at least restart_threshold_frames
+     * frames after that, a restart checkpoint is run so that writers start
+     * again from the beginning of the WAL, or a truncate checkpoint if it has
+     * at least truncate_threshold_frames frames, which also shrinks the WAL
+     * file. Restart and truncate checkpoints wait for readers for up to
+     * busy_timeout.
+     */
+    struct CheckpointerOptions
+    {
+        /// Number of frames in the WAL at which a passive checkpoint is run.
+        int passive_threshold_frames = 1000;
+        /// Number of frames left in the WAL at which a restart checkpoint is run.
+        int restart_threshold_frames = 4000;
+        /// Number of frames left in the WAL at which a truncate checkpoint is run.
+        int truncate_threshold_frames = 16000;
+        /// Longest time between checkpoints while the WAL has frames.
+        std::chrono::milliseconds interval{1000};
+        /// Longest time that restart and truncate checkpoints wait for readers.
+        std::chrono::milliseconds busy_timeout{100};
+        /// Function called on the checkpointer thread after each checkpoint.
+        std::function<void(const CheckpointReport&)> report_callback;
+    };
+
+    /**
+     * Runs checkpoints of a database in WAL mode from a background thread,
+     * so that writers do not pay for checkpoints when commits cross the
+     * automatic checkpoint threshold.
+     *
+     * The checkpointer uses its own database connection. Writer connections
+     * are attached to it, which disables their automatic checkpoints and
+     * lets their commits wake the checkpointer once the WAL has grown past
+     * the passive threshold.
+     */
+    class Checkpointer
+    {
+    public:
+        Checkpointer(const Checkpointer& other) = delete;
+        void operator=(const Checkpointer& other) = delete;
+
+        /**
+         * Opens a database connection to the database in WAL mode given by
+         * filename and starts the checkpointer thread.
+         *
+         * Throws sqlitemm::Error if the database cannot be opened.
+         */
+        explicit Checkpointer(const std::string& filename, CheckpointerOptions options = CheckpointerOptions{});
+
+        /**
+         * Stops the checkpointer thread, waiting for any checkpoint in
+         * progress to finish, then closes its database connection.
+         *
+         * Attached writer connections keep their automatic checkpoints
+         * disabled, but no longer wake the checkpointer.
+         */
+        ~Checkpointer();
+
+        /**
+         * Disables automatic checkpoints for writer, a database connection to
+         * the same database, and sets its WAL hook to wake the checkpointer
+         * once the WAL has grown past the passive threshold.
+         *
+         * This replaces any WAL hook of writer, and must not be called while
+         * another thread uses writer. Since restart and truncate checkpoints
+         * briefly hold the write lock, writer should have a busy timeout.
+         */
+        void attach(Connection& writer);
+
+        /**
+         * Wakes the checkpointer thread to check the WAL now.
+         */
+        void wake() noexcept;
+
+        /**
+         * Returns the cumulative counters of the checkpointer.
+         */
+        CheckpointerStats stats() const;
+    private:
+        // state shared with the WAL hooks of attached writers, which may outlive the checkpointer
+        struct WakeState
+        {
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool woken = false;
+            bool stopping = false;
+            int passive_threshold_frames = 0;
+        };
+
+        Connection conn;
+        CheckpointerOptions options;
+        std::shared_ptr<WakeState> state;
+        mutable std::mutex stats_mutex;
+        CheckpointerStats checkpointer_stats;
+        int last_checkpointed_frames = 0; // frames of the WAL reported as checkpointed by the last checkpoint
+        std::thread thread;
+
+        void run() noexcept;
+        void run_checkpoints();
+        void record(CheckpointMode mode, const CheckpointResult& result);
+    };
+}
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef SQLITEMM_POOL_20250601_H_
+#define SQLITEMM_POOL_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm connection pool header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Models a pool of database connections to a WAL mode database file: a
+     * fixed number of read-only connections that may be leased concurrently by
+     * reader threads, and a single read-write connection that is leased by one
+     * writer thread at a time.
+     *
+     * Idle read-only connections are kept in a lock-free free list, so leasing
+     * and returning a reader does not take a lock unless every reader is in
+     * use, in which case the leasing thread waits for one to be returned.
+     */
+    class ConnectionPool
+    {
+    public:
+        /**
+         * Function called once on each connection of the pool after it is
+         * opened, e.g., to set pragmas.
+         */
+        using SetupFunction = std::function<void(Connection&)>;
+
+        /**
+         * Models the lease of a connection from a connection pool. The
+         * connection is returned to the pool when the lease is destroyed or
+         * released.
+         */
+        class Lease
+        {
+        public:
+            Lease(const Lease& other) = delete;
+            void operator=(const Lease& other) = delete;
+
+            /**
+             * Constructs an empty lease, i.e., one that holds no connection.
+             */
+            Lease() noexcept = default;
+
+            /**
+             * Move constructs the lease.
+             */
+            Lease(Lease&& other) noexcept : pool(other.pool), slot(other.slot)
+            {
+                other.pool = nullptr;
+            }
+
+            /**
+             * Move assigns the lease, returning the connection held by this
+             * lease, if any, to its pool.
+             */
+            Lease& operator=(Lease&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    release();
+                    pool = other.pool;
+                    slot = other.slot;
+                    other.pool = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * Returns the connection held by this lease, if any, to its pool.
+             */
+            ~Lease()
+            {
+                release();
+            }
+
+            /**
+             * Returns the connection held by this lease, if any, to its pool,
+             * leaving this lease empty.
+             */
+            void release() noexcept;
+
+            /**
+             * Returns true if the lease holds a connection.
+             */
+            explicit operator bool() const noexcept
+            {
+                return pool != nullptr;
+            }
+
+            /**
+             * Returns the leased connection.
+             */
+            Connection& operator*() const noexcept
+            {
+                return get();
+            }
+
+            /**
+             * Returns the leased connection.
+             */
+            Connection* operator->() const noexcept
+            {
+                return &get();
+            }
+
+            /**
+             * Returns the leased connection.
+             */
+            Connection& get() const noexcept;
+        private:
+            ConnectionPool* pool = nullptr; // pool that the connection is leased from
+            std::uint32_t slot = 0;         // index of the reader slot, or writer_slot
+
+            Lease(ConnectionPool* pool, std::uint32_t slot) noexcept : pool(pool), slot(slot) {}
+
+            friend class ConnectionPool;
+        };
+
+        ConnectionPool(const ConnectionPool& other) = delete;
+        void operator=(const ConnectionPool& other) = delete;
+
+        /**
+         * Constructs a connection pool by opening the writer connection to the
+         * database specified by filename, creating the database if it does
+         * not exist and switching it to WAL journal mode, then opening
+         * reader_count read-only connections to it.
+         *
+         * Each connection is given the busy timeout in milliseconds, then
+         * passed to the setup function, if any.
+         *
+         * Throws std::invalid_argument if reader_count is zero, or
+         * sqlitemm::Error if a connection cannot be opened, or if the
+         * database cannot be switched to WAL journal mode.
+         */
+        ConnectionPool(
+            const std::string& filename,
+            size_t reader_count,
+            SetupFunction setup = SetupFunction{},
+            int busy_timeout_ms = 5000
+        );
+
+        /**
+         * Destroys the connection pool, closing its connections. The pool
+         * must not be destroyed while any of its connections are leased.
+         */
+        ~ConnectionPool();
+
+        /**
+         * Leases a read-only connection, waiting for one to be returned if
+         * they are all leased.
+         */
+        Lease acquire_reader();
+
+        /**
+         * Leases a read-only connection if one is idle, otherwise returns an
+         * empty lease.
+         */
+        Lease try_acquire_reader() noexcept;
+
+        /**
+         * Leases the read-write connection, waiting for it to be returned if
+         * it is leased.
+         */
+        Lease acquire_writer();
+
+        /**
+         * Leases the read-write connection if it is idle, otherwise returns an
+         * empty lease.
+         */
+        Lease try_acquire_writer() noexcept;
+
+        /**
+         * Returns the number of read-only connections in the pool.
+         */
+        size_t reader_count() const noexcept
+        {
+            return num_readers;
+        }
+    private:
+        static constexpr std::uint32_t writer_slot = UINT32_MAX;
+
+        // a read-only connection and the link to the next idle one in the free list
+        struct ReaderSlot
+        {
+            Connection connection;
+            std::atomic<std::uint32_t> next{0}; // 1 + index of the next idle slot, or 0 if none
+        };
+
+        std::unique_ptr<ReaderSlot[]> readers;
+        size_t num_readers;
+        // free list head: ABA tag in the upper 32 bits, 1 + index of the first idle slot (or 0) in the lower
+        std::atomic<std::uint64_t> free_head{0};
+        std::atomic<size_t> num_waiting_readers{0};
+        std::mutex reader_mutex;                   // only used to wait for an idle reader
+        std::condition_variable reader_returned;
+
+        Connection writer;
+        bool writer_leased = false; // guarded by writer_mutex
+        std::mutex writer_mutex;
+        std::condition_variable writer_returned;
+
+        bool try_pop_reader(std::uint32_t& slot) noexcept;
+        void push_reader(std::uint32_t slot) noexcept;
+        void release(std::uint32_t slot) noexcept;
+
+        friend class Lease;
+    };
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef SQLITEMM_RESULT_WRITER_20250601_H_
+#define SQLITEMM_RESULT_WRITER_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm result writer header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Default size in bytes at which a result writer hands its buffer to the
+     * sink as a chunk.
+     */
+    constexpr size_t default_result_writer_chunk_size = 64 * 1024;
+
+    /**
+     * Output formats of a result writer.
+     */
+    enum class ResultFormat
+    {
+        /**
+         * Comma separated values as per RFC 4180, with CRLF line endings, an
+         * optional header row of column names, text quoted only if needed,
+         * BLOBs in hexadecimal, and NULL as an empty field.
+         */
+        Csv,
+        /**
+         * Newline delimited JSON, with each row written as a JSON object keyed
+         * by column name, BLOBs as base64 strings, and NULL (or an infinite
+         * real) as null.
+         */
+        NdJson,
+        /**
+         * Binary format with little-endian integers. The first write begins
+         * with the number of columns as 4 bytes, then each column name as a 4
+         * byte length followed by its UTF-8 bytes. Each row then has one field
+         * per column, each of which is a 1 byte SQLite fundamental type
+         * followed by nothing for NULL, 8 bytes for an integer or IEEE 754
+         * double, or a 4 byte length followed by the bytes for text or a BLOB.
+         */
+        Binary
+    };
+
+    /**
+     * Options of a result writer.
+     */
+    struct ResultWriterOptions
+    {
+        /// Output format.
+        ResultFormat format = ResultFormat::Csv;
+        /// True if a CSV header row of column names is written before the first row.
+        bool header = true;
+        /// Size in bytes of output at which a chunk is completed, always at the end of a row.
+        size_t chunk_size = default_result_writer_chunk_size;
+        /// Function that compresses each completed chunk, if any, e.g., into a gzip member or zstd frame.
+        /// It is called concurrently if compression_threads is greater than 1.
+        std::function<std::vector<unsigned char>(const unsigned char* data, size_t size)> compressor;
+        /// Number of chunks compressed in parallel on other threads, or 0 to compress on the writing thread.
+        unsigned int compression_threads = 0;
+    };
+
+    /**
+     * Writes the rows of result sets to a sink in CSV, NDJSON or a binary
+     * format, formatting the fields straight from SQLite into a reusable
+     * buffer, without converting them to std::string or using iostreams.
+     *
+     * The output is handed to the sink in chunks that end at row
+     * boundaries. If a compressor is set, each chunk is compressed
+     * independently before being handed to the sink, in order, so the
+     * compressor should produce output that can be concatenated, e.g.,
+     * gzip members or zstd frames.
+     */
+    class ResultWriter
+    {
+    public:
+        /**
+         * Function that consumes each chunk of output in turn.
+         */
+        using Sink = std::function<void(const unsigned char* data, size_t size)>;
+
+        ResultWriter(const ResultWriter& other) = delete;
+        void operator=(const ResultWriter& other) = delete;
+
+        /**
+         * Constructs a result writer that hands its output to sink.
+         */
+        explicit ResultWriter(Sink sink, ResultWriterOptions options = ResultWriterOptions{});
+
+        /**
+         * Constructs a result writer that writes its output to the file
+         * descriptor fd, which must remain open until the writer has finished.
+         */
+        explicit ResultWriter(int fd, ResultWriterOptions options = ResultWriterOptions{});
+
+        /**
+         * Destroys the result writer, finishing it if it has not finished.
+         * Errors from finishing are ignored, so finish() should be called
+         * first if they are to be handled.
+         */
+        ~ResultWriter();
+
+        /**
+         * Steps through the remaining rows of result and writes them, and
+         * returns the number of rows written.
+         *
+         * The header of the first write, if any, is written with the column
+         * names of its result set, so later writes should be of result sets
+         * with the same columns.
+         *
+         * Throws sqlitemm::Error if a row cannot be retrieved, or the
+         * exception thrown by the compressor or sink, e.g.,
+         * std::system_error if the file descriptor cannot be written to.
+         */
+        size_t write(Result& result);
+
+        /**
+         * Hands any buffered output to the sink, waiting for the chunks being
+         * compressed.
+         *
+         * Throws the exception thrown by the compressor or sink.
+         */
+        void finish();
+    private:
+        // a completed chunk being compressed, with its buffer to be reused once it has been
+        struct CompressionTask
+        {
+            std::vector<unsigned char> chunk;
+            // declared after the chunk so that it is destroyed first, waiting for the compressor to finish with it
+            std::future<std::vector<unsigned char>> compressed;
+        };
+
+        Sink sink;
+        ResultWriterOptions options;
+        std::vector<unsigned char> buffer;
+        std::vector<std::vector<unsigned char>> spare_buffers;
+        std::deque<CompressionTask> compression_tasks;
+        std::vector<std::string> json_keys; // escaped "name": prefixes of the fields of an NDJSON row
+        bool header_written = false;
+
+        void write_header(Result& result);
+        void write_row(Result& result);
+        void complete_chunk();
+        void drain_compression_task();
+    };
+}
+
+#endif
@@ -0,0 +1,391 @@
+#ifndef SQLITEMM_SESSION_20250601_H_
+#define SQLITEMM_SESSION_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm session header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#if !defined(SQLITE_ENABLE_SESSION) || !defined(SQLITE_ENABLE_PREUPDATE_HOOK)
+#error "sqlitemm_session.hpp requires SQLITE_ENABLE_SESSION and SQLITE_ENABLE_PREUPDATE_HOOK to be defined"
+#endif
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "sqlitemm.hpp"
+// the session extension is only declared by the full SQLite header
+#include "sqlite3.h"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Operations recorded in a changeset.
+     */
+    enum class ChangeOperation
+    {
+        Insert,
+        Update,
+        Delete
+    };
+
+    /**
+     * Kinds of conflict when applying a changeset, as for
+     * sqlite3changeset_apply().
+     */
+    enum class ConflictType
+    {
+        /// The row to update or delete exists, but its values differ from the original values in the changeset.
+        Data,
+        /// The row to update or delete does not exist.
+        NotFound,
+        /// The row to insert has the same primary key as an existing row.
+        Conflict,
+        /// The change violates a constraint other than a foreign key constraint.
+        Constraint,
+        /// Applying the changeset would leave foreign key constraints violated.
+        ForeignKey
+    };
+
+    /**
+     * Actions that a conflict handler can take.
+     */
+    enum class ConflictAction
+    {
+        /// Skip the conflicting change.
+        Omit,
+        /// Replace the conflicting row with the change; only valid for Data and Conflict conflicts, otherwise
+        /// every change is rolled back and sqlitemm::Error with SQLITE_MISUSE is thrown.
+        Replace,
+        /// Roll back every change applied so far and throw sqlitemm::Error.
+        Abort
+    };
+
+    /**
+     * A conflict encountered while applying a changeset, passed to the
+     * conflict handler.
+     *
+     * It is only valid for the duration of the call to the conflict handler.
+     */
+    class ChangesetConflict
+    {
+    public:
+        ChangesetConflict(const ChangesetConflict& other) = delete;
+        void operator=(const ChangesetConflict& other) = delete;
+
+        /**
+         * Returns the kind of conflict.
+         */
+        ConflictType type() const noexcept
+        {
+            return conflict_type;
+        }
+
+        /**
+         * Returns the operation of the conflicting change. Not applicable to
+         * ForeignKey conflicts.
+         */
+        ChangeOperation operation() const noexcept
+        {
+            return change_operation;
+        }
+
+        /**
+         * Returns the name of the table of the conflicting change. Empty for
+         * ForeignKey conflicts.
+         */
+        std::string_view table() const noexcept
+        {
+            return table_name;
+        }
+
+        /**
+         * Returns the number of columns of the table of the conflicting
+         * change.
+         */
+        int column_count() const noexcept
+        {
+            return num_columns;
+        }
+
+        /**
+         * Returns the number of foreign key constraints that would be left
+         * violated, for a ForeignKey conflict.
+         */
+        int foreign_key_conflicts() const;
+
+        /**
+         * Returns the original value of the column in the changeset, for
+         * the Update and Delete operations, converted to type T as for the
+         * arguments of SQL functions created with
+         * Connection::create_function().
+         *
+         * If T is std::optional, a column whose value is NULL or is absent
+         * from the changeset, e.g., an unchanged column of an Update,
+         * results in an empty optional. Otherwise an absent value throws
+         * sqlitemm::NullTypeError.
+         */
+        template<typename T>
+        T old_value(int column) const
+        {
+            return value<T>(&sqlite3changeset_old, column);
+        }
+
+        /**
+         * Returns the new value of the column in the changeset, for the
+         * Insert and Update operations, converted as for old_value().
+         */
+        template<typename T>
+        T new_value(int column) const
+        {
+            return value<T>(&sqlite3changeset_new, column);
+        }
+
+        /**
+         * Returns the value of the column in the conflicting row of the
+         * database, for Data and Conflict conflicts, converted as for
+         * old_value().
+         */
+        template<typename T>
+        T conflicting_value(int column) const
+        {
+            return value<T>(&sqlite3changeset_conflict, column);
+        }
+    private:
+        using ValueGetter = int (*)(sqlite3_changeset_iter*, int, sqlite3_value**);
+
+        ChangesetConflict(sqlite3_changeset_iter* iter, ConflictType conflict_type);
+
+        template<typename T>
+        T value(ValueGetter getter, int column) const;
+
+        // returns the value of the column, or nullptr if it is absent
+        sqlite3_value* raw_value(ValueGetter getter, int column) const;
+
+        sqlite3_changeset_iter* iter;
+        ConflictType conflict_type;
+        ChangeOperation change_operation = ChangeOperation::Insert;
+        std::string_view table_name;
+        int num_columns = 0;
+
+        friend class Session;
+    };
+
+    /**
+     * Records the changes made through a database connection to the tables
+     * of a database, wrapping sqlite3_session, so that they can be
+     * retrieved as a changeset or patchset and applied to another database
+     * with the same schema.
+     *
+     * Changes are recorded while the session is enabled, whether or not
+     * they are made within a Transaction, so a changeset of a single
+     * transaction can be retrieved by creating the session before beginning
+     * the transaction and retrieving the changeset after committing it. A
+     * change that is rolled back is not recorded.
+     *
+     * Only tables with a declared PRIMARY KEY are recorded. The session must
+     * be destroyed before its database connection is closed.
+     */
+    class Session
+    {
+    public:
+        /**
+         * Function called when applying a changeset with each conflict, which
+         * returns the action to be taken.
+         */
+        using ConflictHandler = std::function<ConflictAction(const ChangesetConflict& conflict)>;
+
+        /**
+         * Function called when applying a changeset with the name of each
+         * table in the changeset, which returns true if the changes to that
+         * table are to be applied.
+         */
+        using TableFilter = std::function<bool(std::string_view table)>;
+
+        /**
+         * Function called when streaming a changeset out with each chunk of
+         * it in turn.
+         */
+        using ChangesetOutput = std::function<void(const unsigned char* data, std::size_t size)>;
+
+        /**
+         * Function called when streaming a changeset in to fill the buffer
+         * of capacity bytes with the next chunk of it, which returns the
+         * number of bytes written, or zero at the end of the changeset.
+         */
+        using ChangesetInput = std::function<std::size_t(unsigned char* buffer, std::size_t capacity)>;
+
+        Session() = delete;
+        Session(const Session& other) = delete;
+        void operator=(const Session& other) = delete;
+
+        /**
+         * Creates an enabled session recording the changes made through conn
+         * to the tables of the database with the given schema name, once
+         * they are attached.
+         *
+         * Throws sqlitemm::Error if the session cannot be created.
+         */
+        explicit Session(Connection& conn, const std::string& schema_name = "main");
+
+        /**
+         * Move constructs the session.
+         */
+        Session(Session&& other) noexcept : db(other.db), session(other.session)
+        {
+            other.db = nullptr;
+            other.session = nullptr;
+        }
+
+        /**
+         * Move assigns the session.
+         */
+        Session& operator=(Session&& other) noexcept
+        {
+            using std::swap;
+            swap(db, other.db);
+            swap(session, other.session);
+            return *this;
+        }
+
+        /**
+         * Destroys the session, discarding the changes recorded.
+         */
+        ~Session()
+        {
+            close();
+        }
+
+        /**
+         * Records changes to the table with the given name.
+         *
+         * Throws sqlitemm::Error if the table cannot be attached.
+         */
+        void attach(const std::string& table);
+
+        /**
+         * Records changes to every table of the database, including tables
+         * created after this call.
+         *
+         * Throws sqlitemm::Error if the tables cannot be attached.
+         */
+        void attach_all();
+
+        /**
+         * Enables or disables recording changes.
+         */
+        void enable(bool enabled) noexcept;
+
+        /**
+         * Returns true if changes are being recorded.
+         */
+        bool enabled() const noexcept;
+
+        /**
+         * Returns true if no changes have been recorded.
+         */
+        bool empty() const noexcept;
+
+        /**
+         * Returns a changeset of the changes recorded, with the original
+         * values of updated and deleted rows so that conflicts can be
+         * detected when it is applied.
+         *
+         * Throws sqlitemm::Error if the changeset cannot be generated.
+         */
+        std::vector<unsigned char> changeset();
+
+        /**
+         * Streams a changeset of the changes recorded to output in chunks,
+         * without holding the whole changeset in memory.
+         *
+         * Throws sqlitemm::Error if the changeset cannot be generated, or
+         * the exception thrown by output.
+         */
+        void changeset(const ChangesetOutput& output);
+
+        /**
+         * Returns a patchset of the changes recorded, which is smaller than
+         * the changeset since it only has the primary keys of deleted rows
+         * and the primary keys and new values of updated rows, so fewer
+         * conflicts can be detected when it is applied.
+         *
+         * Throws sqlitemm::Error if the patchset cannot be generated.
+         */
+        std::vector<unsigned char> patchset();
+
+        /**
+         * Streams a patchset of the changes recorded to output in chunks, as
+         * for changeset(output).
+         */
+        void patchset(const ChangesetOutput& output);
+
+        /**
+         * Applies a changeset or patchset to the database of conn within a
+         * Savepoint, calling on_conflict with each conflict, and only
+         * applying the changes to the tables that filter accepts, if given.
+         *
+         * If on_conflict is empty, the first conflict aborts. On abort, or if
+         * on_conflict or filter throws, every change is rolled back and
+         * sqlitemm::Error or the exception thrown is propagated.
+         */
+        static void apply(Connection& conn, BlobView changeset, const ConflictHandler& on_conflict = {},
+                          const TableFilter& filter = {});
+
+        /**
+         * Applies a changeset or patchset streamed in chunks from input, as
+         * for apply(), without holding the whole changeset in memory.
+         *
+         * If input throws, every change is rolled back and the exception is
+         * propagated.
+         */
+        static void apply_stream(Connection& conn, const ChangesetInput& input,
+                                 const ConflictHandler& on_conflict = {}, const TableFilter& filter = {});
+
+        /**
+         * Deletes the session handle, discarding the changes recorded.
+         */
+        void close() noexcept;
+    private:
+        sqlite3* db = nullptr; // database connection handle for error reporting
+        sqlite3_session* session = nullptr; // session handle
+
+        static int handle_conflict(void* context, int conflict, sqlite3_changeset_iter* iter) noexcept;
+    };
+
+    template<typename T>
+    T ChangesetConflict::value(ValueGetter getter, int column) const
+    {
+        auto raw = raw_value(getter, column);
+        if constexpr (detail::is_optional<T>::value)
+        {
+            if (!raw)
+            {
+                return T();
+            }
+        }
+        else if (!raw)
+        {
+            throw NullTypeError("value is not in the changeset", SQLITE_MISMATCH);
+        }
+        return Connection::function_argument<T>(raw);
+    }
+}
+
+#endif
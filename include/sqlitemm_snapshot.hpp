@@ -0,0 +1,89 @@
+#ifndef SQLITEMM_SNAPSHOT_20250601_H_
+#define SQLITEMM_SNAPSHOT_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm snapshot header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstddef>
+#include <string>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * A database file mapped read-only into memory once, to be shared by any
+     * number of read-only database connections in the process.
+     *
+     * Each connection reads pages from the mapping in place, so adding
+     * reader connections, e.g., one per thread, adds neither page cache
+     * memory nor file reads, and the readers take no file locks.
+     *
+     * The database file must not be changed while it is mapped, and every
+     * database connection to the snapshot must be closed before the
+     * snapshot is destroyed.
+     */
+    class SharedSnapshot
+    {
+    public:
+        SharedSnapshot(const SharedSnapshot& other) = delete;
+        void operator=(const SharedSnapshot& other) = delete;
+
+        /**
+         * Maps the database file given by filename into memory.
+         *
+         * Throws std::system_error if the file cannot be opened or mapped.
+         */
+        explicit SharedSnapshot(const std::string& filename);
+
+        /**
+         * Unmaps the database file.
+         */
+        ~SharedSnapshot();
+
+        /**
+         * Returns a new read-only database connection to the snapshot.
+         *
+         * Throws sqlitemm::Error if the database connection cannot be opened.
+         */
+        Connection connect() const;
+
+        /**
+         * Returns a pointer to the mapped content of the database file.
+         */
+        const unsigned char* data() const noexcept
+        {
+            return image;
+        }
+
+        /**
+         * Returns the size of the database file in bytes.
+         */
+        std::size_t size() const noexcept
+        {
+            return image_size;
+        }
+    private:
+        const unsigned char* image = nullptr;
+        std::size_t image_size = 0;
+#ifdef _WIN32
+        void* mapping = nullptr; // handle of the file mapping object
+#endif
+    };
+}
+
+#endif
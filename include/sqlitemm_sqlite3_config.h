@@ -0,0 +1,107 @@
+#ifndef SQLITEMM_SQLITE3_CONFIG_20250601_H_
+#define SQLITEMM_SQLITE3_CONFIG_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm SQLite compile-time options header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+/*
+ * Compile-time options for building the SQLite amalgamation for use with
+ * sqlitemm, following the options recommended by the SQLite documentation.
+ *
+ * This header is included at the top of sqlite3.c by compiling it with
+ * SQLITE_CUSTOM_INCLUDE=sqlitemm_sqlite3_config.h, as the release targets of
+ * the provided Makefile do. Each option may be overridden by defining it on
+ * the command line instead.
+ */
+
+/*
+ * Keep the mutexes compiled in: ConnectionPool, BackupJob and
+ * AsyncConnection open their connections with SQLITE_OPEN_NOMUTEX for the
+ * multi-thread threading mode, but connections shared across threads still
+ * need the serialized threading mode that SQLITE_THREADSAFE=0 would remove.
+ */
+#ifndef SQLITE_THREADSAFE
+#define SQLITE_THREADSAFE 1
+#endif
+
+/*
+ * Do not track memory usage for sqlite3_status(), which takes a global mutex
+ * on every allocation. Per-connection counters from sqlite3_db_status(), as
+ * used by Connection::database_status(), are unaffected.
+ */
+#ifndef SQLITE_DEFAULT_MEMSTATUS
+#define SQLITE_DEFAULT_MEMSTATUS 0
+#endif
+
+/*
+ * Treat double-quoted strings only as identifiers, so that a misspelt column
+ * name is an error rather than a string literal.
+ */
+#ifndef SQLITE_DQS
+#define SQLITE_DQS 0
+#endif
+
+/*
+ * Use synchronous=NORMAL by default in WAL mode, which remains durable across
+ * application crashes and consistent across power loss.
+ */
+#ifndef SQLITE_DEFAULT_WAL_SYNCHRONOUS
+#define SQLITE_DEFAULT_WAL_SYNCHRONOUS 1
+#endif
+
+/*
+ * Do not bother checking the expression tree depth, nor matching BLOBs with
+ * LIKE and GLOB.
+ */
+#ifndef SQLITE_MAX_EXPR_DEPTH
+#define SQLITE_MAX_EXPR_DEPTH 0
+#endif
+#ifndef SQLITE_LIKE_DOESNT_MATCH_BLOBS
+#define SQLITE_LIKE_DOESNT_MATCH_BLOBS 1
+#endif
+
+/*
+ * Omit interfaces that sqlitemm does not use: the deprecated interfaces and
+ * shared cache mode.
+ */
+#ifndef SQLITE_OMIT_DEPRECATED
+#define SQLITE_OMIT_DEPRECATED 1
+#endif
+#ifndef SQLITE_OMIT_SHARED_CACHE
+#define SQLITE_OMIT_SHARED_CACHE 1
+#endif
+
+/*
+ * Allow memory-mapping database files larger than the default limit of just
+ * under 2 GB on 64-bit platforms where SQLite supports memory-mapped I/O, so
+ * that Connection::open_readonly_snapshot() maps a multi-GB database whole
+ * rather than reading the rest of it through the page cache. Only the size of
+ * the file is mapped, however large the limit.
+ */
+#ifndef SQLITE_MAX_MMAP_SIZE
+#if defined(_WIN64) \
+    || (defined(__LP64__) && (defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(__FreeBSD__)))
+#define SQLITE_MAX_MMAP_SIZE 0x10000000000 /* 1 TB */
+#endif
+#endif
+
+/*
+ * Allocate small temporary buffers on the stack.
+ */
+#ifndef SQLITE_USE_ALLOCA
+#define SQLITE_USE_ALLOCA 1
+#endif
+
+#endif
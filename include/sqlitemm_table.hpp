@@ -0,0 +1,235 @@
+#ifndef SQLITEMM_TABLE_20250601_H_
+#define SQLITEMM_TABLE_20250601_H_
+
+/************************************************************************************************************
+ * SQLitemm table mapping header file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "sqlitemm.hpp"
+
+/**
+ * sqlitemm library.
+ */
+namespace sqlitemm
+{
+    /**
+     * Maps the data member of type M of the row type T to the column of a
+     * table with the given name.
+     */
+    template<typename T, typename M>
+    struct Column
+    {
+        /// Name of the column.
+        std::string_view name;
+        /// Data member holding the value of the column.
+        M T::* member;
+    };
+
+    /**
+     * Returns the mapping of member to the column with the given name.
+     */
+    template<typename T, typename M>
+    constexpr Column<T, M> column(std::string_view name, M T::* member) noexcept
+    {
+        return Column<T, M>{name, member};
+    }
+
+    /**
+     * Typed access to a table whose rows are mapped to objects of type T,
+     * which must be default constructible, with each column mapped once to
+     * a data member of type Ms.
+     *
+     * The first column is the primary key used by find(). The INSERT and
+     * SELECT statements are generated from the mapping and prepared when the
+     * table object is constructed, and the data members are bound to and
+     * decoded from the statements by position, with the conversions resolved
+     * at compile time as for Statement::bind() and Result::row_as(), so no
+     * name is looked up per row.
+     *
+     * The table object must not outlive its database connection.
+     */
+    template<typename T, typename... Ms>
+    class Table
+    {
+        static_assert(sizeof...(Ms) > 0, "table must map at least one column");
+    public:
+        /// Type of the primary key, i.e., of the data member of the first column.
+        using key_type = std::tuple_element_t<0, std::tuple<Ms...>>;
+
+        /**
+         * Prepares the statements for the table with the given name through
+         * conn, with the columns mapped as given, starting with the primary
+         * key.
+         *
+         * Throws sqlitemm::Error if a statement cannot be prepared, e.g.,
+         * because the table or a column does not exist.
+         */
+        Table(Connection& conn, std::string_view table_name, Column<T, Ms>... columns) :
+            conn(&conn),
+            members(columns.member...),
+            insert_statement(conn.prepare(insert_sql(table_name, {columns.name...}))),
+            find_statement(conn.prepare(
+                select_sql(table_name, {columns.name...}) + " WHERE " + quote_identifier(first_name(columns...)) + " = ?"
+            )),
+            scan_statement(conn.prepare(select_sql(table_name, {columns.name...}))) {}
+
+        /**
+         * Inserts obj as a new row, and returns its rowid.
+         *
+         * Throws sqlitemm::ConstraintError if this violates a constraint,
+         * e.g., because a row with the same primary key exists, or
+         * sqlitemm::Error on other errors.
+         */
+        long long insert(const T& obj)
+        {
+            std::apply([this, &obj](auto... member) { insert_statement.execute(obj.*member...); }, members);
+            return conn->last_insert_rowid();
+        }
+
+        /**
+         * Returns the row with the given primary key, or an empty optional if
+         * there is no such row.
+         *
+         * Throws sqlitemm::Error if the row cannot be retrieved.
+         */
+        std::optional<T> find(const key_type& key)
+        {
+            auto result = find_statement.query(key);
+            std::optional<T> obj;
+            try
+            {
+                if (result.step())
+                {
+                    obj = decode(result);
+                }
+            }
+            catch (...)
+            {
+                find_statement.try_reset();
+                throw;
+            }
+            // ends the read transaction now rather than on the next find()
+            find_statement.try_reset();
+            return obj;
+        }
+
+        /**
+         * Calls visitor with each row of the table, decoded as an object of
+         * type T.
+         *
+         * Throws sqlitemm::Error if a row cannot be retrieved, or the
+         * exception thrown by visitor.
+         */
+        template<typename Visitor>
+        void scan(Visitor&& visitor)
+        {
+            auto result = scan_statement.query();
+            try
+            {
+                while (result.step())
+                {
+                    visitor(decode(result));
+                }
+            }
+            catch (...)
+            {
+                scan_statement.try_reset();
+                throw;
+            }
+        }
+
+        /**
+         * Returns every row of the table, decoded as objects of type T.
+         *
+         * Throws sqlitemm::Error if a row cannot be retrieved.
+         */
+        std::vector<T> scan()
+        {
+            std::vector<T> objects;
+            scan([&objects](T&& obj) { objects.push_back(std::move(obj)); });
+            return objects;
+        }
+    private:
+        Connection* conn;
+        std::tuple<Ms T::*...> members;
+        Statement insert_statement;
+        Statement find_statement;
+        Statement scan_statement;
+
+        T decode(const Result& result) const
+        {
+            return std::apply([&result](auto... member) { return result.row_as<T>(member...); }, members);
+        }
+
+        template<typename First, typename... Rest>
+        static std::string_view first_name(const First& first, const Rest&...) noexcept
+        {
+            return first.name;
+        }
+
+        static std::string quote_identifier(std::string_view identifier)
+        {
+            std::string quoted = "\"";
+            for (char c : identifier)
+            {
+                if (c == '"')
+                {
+                    quoted += '"';
+                }
+                quoted += c;
+            }
+            quoted += '"';
+            return quoted;
+        }
+
+        static std::string column_list(std::initializer_list<std::string_view> names)
+        {
+            std::string list;
+            for (auto name : names)
+            {
+                if (!list.empty())
+                {
+                    list += ", ";
+                }
+                list += quote_identifier(name);
+            }
+            return list;
+        }
+
+        static std::string insert_sql(std::string_view table_name, std::initializer_list<std::string_view> names)
+        {
+            std::string placeholders;
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                placeholders += (i == 0) ? "?" : ", ?";
+            }
+            return "INSERT INTO " + quote_identifier(table_name) + " (" + column_list(names) + ") VALUES ("
+                + placeholders + ")";
+        }
+
+        static std::string select_sql(std::string_view table_name, std::initializer_list<std::string_view> names)
+        {
+            return "SELECT " + column_list(names) + " FROM " + quote_identifier(table_name);
+        }
+    };
+}
+
+#endif
@@ -15,13 +15,22 @@
 
 #include "sqlitemm.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cctype>
+#include <chrono>
+#include <cstring>
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include <iostream>
+#include "sqlite3.h"
 
 namespace sqlitemm
 {
@@ -130,6 +139,537 @@ namespace sqlitemm
                 throw TypeError(ss.str(), 0);
             }
         }
+
+        // returns the column storage type for the affinity of a declared type, as per SQLite's rules
+        int get_affinity_column_type(const char* declared_type)
+        {
+            if (!declared_type || !*declared_type)
+            {
+                return SQLITE_BLOB;
+            }
+
+            std::string type(declared_type);
+            for (auto& c : type)
+            {
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+            auto contains = [&type](const char* name) { return type.find(name) != std::string::npos; };
+            if (contains("INT"))
+            {
+                return SQLITE_INTEGER;
+            }
+            if (contains("CHAR") || contains("CLOB") || contains("TEXT"))
+            {
+                return SQLITE_TEXT;
+            }
+            if (contains("BLOB"))
+            {
+                return SQLITE_BLOB;
+            }
+            return SQLITE_FLOAT;
+        }
+
+        long long steady_clock_nanoseconds() noexcept
+        {
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        }
+
+        sqlite3_stmt* prepare_statement(sqlite3* db, const std::string& sql)
+        {
+            sqlite3_stmt* stmt;
+            int result_code = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+            check_result_ok(db, result_code);
+            return stmt;
+        }
+    }
+
+    /**
+     * Registry of the prepared statements of a database connection.
+     *
+     * Live statements link themselves into an intrusive list so that they can
+     * be registered and unregistered in constant time without allocating, and
+     * so that they can be finalized when the database connection is closed.
+     * Idle statements from the statement cache are kept in a multimap keyed by
+     * the SQL text that they were requested with, which is kept by the
+     * statement itself since sqlite3_sql() omits any text after the first SQL
+     * statement, and reuse the same links to form the least recently used
+     * list. Map nodes are recycled so that a statement cache that has warmed
+     * up does not allocate when statements are reused.
+     */
+    class StatementRegistry
+    {
+    public:
+        StatementRegistry() = default;
+        StatementRegistry(const StatementRegistry& other) = delete;
+        void operator=(const StatementRegistry& other) = delete;
+
+        ~StatementRegistry()
+        {
+            assert(!head && "live statements must be finalized before the registry is destroyed");
+            clear_cache();
+            finalize_control_statements();
+        }
+
+        /**
+         * Statements that control transactions, prepared once on first use.
+         */
+        enum ControlStatement
+        {
+            begin_deferred,
+            begin_immediate,
+            begin_exclusive,
+            commit,
+            rollback,
+            savepoint,
+            release_savepoint,
+            rollback_to_savepoint,
+            control_statement_count
+        };
+
+        /**
+         * Executes the control statement, preparing it if it has not been
+         * prepared.
+         *
+         * Returns the result code of preparing or executing it, with the error
+         * message available through sqlite3_errmsg().
+         */
+        int execute_control(sqlite3* db, ControlStatement control) noexcept
+        {
+            static const char* const control_sql[control_statement_count] = {
+                "BEGIN DEFERRED",
+                "BEGIN IMMEDIATE",
+                "BEGIN EXCLUSIVE",
+                "COMMIT",
+                "ROLLBACK",
+                // nested savepoints can share a name since RELEASE and ROLLBACK TO apply to the most recent one
+                "SAVEPOINT sqlitemm_savepoint",
+                "RELEASE sqlitemm_savepoint",
+                "ROLLBACK TO sqlitemm_savepoint"
+            };
+
+            sqlite3_stmt*& stmt = control_statements[control];
+            if (!stmt)
+            {
+                int result_code = sqlite3_prepare_v3(
+                    db, control_sql[control], -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr
+                );
+                if (result_code != SQLITE_OK)
+                {
+                    return result_code;
+                }
+            }
+
+            // resetting after an error keeps the error message available through sqlite3_errmsg()
+            int result_code = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            return (result_code == SQLITE_DONE) ? SQLITE_OK : result_code;
+        }
+
+        /**
+         * Executes the control statement as for execute_control(), but throws
+         * an exception on error.
+         */
+        void check_execute_control(sqlite3* db, ControlStatement control)
+        {
+            check_result_ok(db, execute_control(db, control));
+        }
+
+        /**
+         * Finalizes the control statements so that the database connection
+         * can be closed.
+         */
+        void finalize_control_statements() noexcept
+        {
+            for (auto& stmt : control_statements)
+            {
+                sqlite3_finalize(stmt);
+                stmt = nullptr;
+            }
+        }
+
+        /**
+         * Links the statement into the registry as a live statement.
+         */
+        void add(Statement& statement) noexcept
+        {
+            statement.registry = this;
+            statement.prev = nullptr;
+            statement.next = head;
+            if (head)
+            {
+                head->prev = &statement;
+            }
+            head = &statement;
+        }
+
+        /**
+         * Unlinks the live statement from the registry.
+         */
+        void remove(Statement& statement) noexcept
+        {
+            unlink(statement, head, nullptr);
+            statement.registry = nullptr;
+        }
+
+        /**
+         * Transfers the place of the live statement from, which is being moved
+         * from, to the statement to.
+         */
+        void transfer(Statement& from, Statement& to) noexcept
+        {
+            to.registry = this;
+            to.prev = from.prev;
+            to.next = from.next;
+            (to.prev ? to.prev->next : head) = &to;
+            if (to.next)
+            {
+                to.next->prev = &to;
+            }
+            from.registry = nullptr;
+            from.prev = nullptr;
+            from.next = nullptr;
+        }
+
+        /**
+         * Finalizes every live statement, leaving them empty.
+         */
+        void finalize_all() noexcept
+        {
+            while (head)
+            {
+                Statement& statement = *head;
+                remove(statement);
+                sqlite3_finalize(statement.stmt);
+                statement.stmt = nullptr;
+                statement.cached = false;
+                statement.parameter_indices.clear();
+                statement.owned_text.clear();
+            }
+        }
+
+        /**
+         * Returns a live statement for sql from the statement cache if there
+         * is an idle one, otherwise prepares a new one that will be returned
+         * to the statement cache.
+         */
+        Statement acquire(sqlite3* db, const std::string& sql)
+        {
+            auto found = cache.find(std::string_view(sql));
+            if (found == cache.end())
+            {
+                ++cache_stats.misses;
+                Statement statement(prepare_statement(db, sql), this);
+                statement.cached = statement.stmt != nullptr;
+                statement.cache_key = sql;
+                return statement;
+            }
+
+            ++cache_stats.hits;
+            unlink(found->second, lru_head, &lru_tail);
+            auto node = cache.extract(found);
+            Statement statement(std::move(node.mapped()));
+            recycle(std::move(node));
+            add(statement);
+            statement.cached = true;
+            return statement;
+        }
+
+        /**
+         * Resets the statement, which must already have been unlinked from
+         * the registry, clears its bindings, and moves it into the statement
+         * cache as the most recently used idle statement, evicting the least
+         * recently used idle statement if the statement cache is full.
+         *
+         * Returns true if resetting the statement reported no error.
+         */
+        bool release(Statement& statement) noexcept
+        {
+            sqlite3_stmt* stmt = statement.stmt;
+            bool is_ok = sqlite3_reset(stmt) == SQLITE_OK;
+            sqlite3_clear_bindings(stmt);
+            statement.clear_owned_text();
+            statement.parameter_index = 1;
+
+            if (cache_capacity == 0)
+            {
+                finalize_idle(statement);
+                return is_ok;
+            }
+
+            Statement* idle = nullptr;
+            try
+            {
+                cache_type::node_type node;
+                if (!spare_nodes.empty())
+                {
+                    node = std::move(spare_nodes.back());
+                    spare_nodes.pop_back();
+                }
+                else
+                {
+                    // nodes can only be allocated by the map, so an empty one is emplaced and extracted
+                    node = cache.extract(cache.emplace(std::string_view(), Statement(nullptr, nullptr)));
+                }
+                node.mapped() = std::move(statement);
+                // the key refers to the text kept by the idle statement, which stays in place in its node
+                node.key() = node.mapped().cache_key;
+                idle = &cache.insert(std::move(node))->second;
+            }
+            catch (...)
+            {
+                finalize_idle(statement);
+                return is_ok;
+            }
+
+            idle->prev = nullptr;
+            idle->next = lru_head;
+            (lru_head ? lru_head->prev : lru_tail) = idle;
+            lru_head = idle;
+            evict_to(cache_capacity);
+            return is_ok;
+        }
+
+        /**
+         * Finalizes every idle statement in the statement cache.
+         */
+        void clear_cache() noexcept
+        {
+            for (auto&& entry : cache)
+            {
+                finalize_idle(entry.second);
+            }
+            cache.clear();
+            spare_nodes.clear();
+            lru_head = nullptr;
+            lru_tail = nullptr;
+        }
+
+        /**
+         * Changes the maximum number of idle statements in the statement
+         * cache.
+         */
+        void set_cache_capacity(size_t capacity)
+        {
+            cache_capacity = capacity;
+            evict_to(capacity);
+            cache.reserve(capacity + 1);
+            spare_nodes.reserve(capacity);
+        }
+
+        size_t cache_capacity = 0; // maximum number of idle statements
+        StatementCacheStats cache_stats;
+    private:
+        using cache_type = std::unordered_multimap<std::string_view, Statement>;
+
+        Statement* head = nullptr;      // most recently registered live statement
+        cache_type cache;               // idle statements keyed by their SQL text
+        Statement* lru_head = nullptr;  // most recently used idle statement
+        Statement* lru_tail = nullptr;  // least recently used idle statement
+        std::vector<cache_type::node_type> spare_nodes; // map nodes available for reuse
+        sqlite3_stmt* control_statements[control_statement_count] = {}; // prepared on first use
+
+        static void unlink(Statement& statement, Statement*& first, Statement** last) noexcept
+        {
+            (statement.prev ? statement.prev->next : first) = statement.next;
+            if (statement.next)
+            {
+                statement.next->prev = statement.prev;
+            }
+            else if (last)
+            {
+                *last = statement.prev;
+            }
+            statement.prev = nullptr;
+            statement.next = nullptr;
+        }
+
+        static void finalize_idle(Statement& statement) noexcept
+        {
+            sqlite3_finalize(statement.stmt);
+            statement.stmt = nullptr;
+            statement.cached = false;
+        }
+
+        void recycle(cache_type::node_type&& node) noexcept
+        {
+            if (spare_nodes.size() < spare_nodes.capacity())
+            {
+                spare_nodes.push_back(std::move(node));
+            }
+        }
+
+        void evict_to(size_t max_entries) noexcept
+        {
+            while (cache.size() > max_entries)
+            {
+                Statement& statement = *lru_tail;
+                unlink(statement, lru_head, &lru_tail);
+                auto range = cache.equal_range(std::string_view(statement.cache_key));
+                for (auto it = range.first; it != range.second; ++it)
+                {
+                    if (&it->second == &statement)
+                    {
+                        finalize_idle(statement);
+                        recycle(cache.extract(it));
+                        break;
+                    }
+                }
+                ++cache_stats.evictions;
+            }
+        }
+    };
+
+    /**
+     * Records a StatementProfile per SQL text from the SQLITE_TRACE_PROFILE
+     * events of a database connection.
+     *
+     * Trace callbacks are serialized by the database connection, so only
+     * they touch the index by SQL text. The counters are atomic so that
+     * snapshots can be taken concurrently, with the mutex only guarding the
+     * list of entries, which grows the first time a SQL text is executed.
+     */
+    class StatementProfiler
+    {
+    public:
+        StatementProfiler() = default;
+        StatementProfiler(const StatementProfiler& other) = delete;
+        void operator=(const StatementProfiler& other) = delete;
+
+        static int trace(unsigned type, void* context, void* p, void* x) noexcept
+        {
+            if (type == SQLITE_TRACE_PROFILE)
+            {
+                auto stmt = static_cast<sqlite3_stmt*>(p);
+                auto nanoseconds = *static_cast<sqlite3_int64*>(x);
+                static_cast<StatementProfiler*>(context)->record(stmt, static_cast<unsigned long long>(nanoseconds));
+            }
+            return 0;
+        }
+
+        std::vector<StatementProfile> snapshot() const
+        {
+            std::lock_guard<std::mutex> lock(entries_mutex);
+            std::vector<StatementProfile> profiles;
+            profiles.reserve(entries.size());
+            for (const auto& entry : entries)
+            {
+                StatementProfile profile;
+                profile.sql = entry->sql;
+                profile.calls = entry->calls.load(std::memory_order_relaxed);
+                profile.total_nanoseconds = entry->total_nanoseconds.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < statement_latency_buckets; ++i)
+                {
+                    profile.latency_histogram[i] = entry->latency_histogram[i].load(std::memory_order_relaxed);
+                }
+                profile.fullscan_steps = entry->fullscan_steps.load(std::memory_order_relaxed);
+                profile.sorts = entry->sorts.load(std::memory_order_relaxed);
+                profile.autoindex_rows = entry->autoindex_rows.load(std::memory_order_relaxed);
+                profile.vm_steps = entry->vm_steps.load(std::memory_order_relaxed);
+                profiles.push_back(std::move(profile));
+            }
+            return profiles;
+        }
+    private:
+        using Counter = std::atomic<unsigned long long>;
+
+        struct Entry
+        {
+            explicit Entry(const char* sql) : sql(sql) {}
+
+            const std::string sql;
+            Counter calls{0};
+            Counter total_nanoseconds{0};
+            std::array<Counter, statement_latency_buckets> latency_histogram{};
+            Counter fullscan_steps{0};
+            Counter sorts{0};
+            Counter autoindex_rows{0};
+            Counter vm_steps{0};
+        };
+
+        mutable std::mutex entries_mutex;
+        std::vector<std::unique_ptr<Entry>> entries;
+        // keys are views of the SQL text owned by the entries
+        std::unordered_map<std::string_view, Entry*> entries_by_sql;
+
+        static size_t latency_bucket(unsigned long long nanoseconds) noexcept
+        {
+            size_t bucket = 0;
+            for (nanoseconds >>= 10; nanoseconds != 0 && bucket + 1 < statement_latency_buckets; nanoseconds >>= 1)
+            {
+                ++bucket;
+            }
+            return bucket;
+        }
+
+        static void add(Counter& counter, unsigned long long value) noexcept
+        {
+            // only trace callbacks write the counters, and they are serialized
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        void record(sqlite3_stmt* stmt, unsigned long long nanoseconds) noexcept
+        {
+            const char* sql = sqlite3_sql(stmt);
+            if (!sql)
+            {
+                return;
+            }
+
+            Entry* entry = nullptr;
+            auto found = entries_by_sql.find(std::string_view(sql));
+            if (found != entries_by_sql.end())
+            {
+                entry = found->second;
+            }
+            else
+            {
+                try
+                {
+                    std::unique_ptr<Entry> new_entry(new Entry(sql));
+                    {
+                        std::lock_guard<std::mutex> lock(entries_mutex);
+                        entries.reserve(entries.size() + 1);
+                    }
+                    entries_by_sql.emplace(std::string_view(new_entry->sql), new_entry.get());
+                    entry = new_entry.get();
+                    std::lock_guard<std::mutex> lock(entries_mutex);
+                    entries.push_back(std::move(new_entry));
+                }
+                catch (...)
+                {
+                    // dropping a sample is preferable to failing the statement
+                    return;
+                }
+            }
+
+            add(entry->calls, 1);
+            add(entry->total_nanoseconds, nanoseconds);
+            add(entry->latency_histogram[latency_bucket(nanoseconds)], 1);
+            add(entry->fullscan_steps, sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1));
+            add(entry->sorts, sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1));
+            add(entry->autoindex_rows, sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1));
+            add(entry->vm_steps, sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1));
+        }
+    };
+
+
+    std::string Status::message() const
+    {
+        // the error message of the database connection only describes this status if the result codes match
+        if (db && sqlite3_extended_errcode(db) == result_code)
+        {
+            return sqlite3_errmsg(db);
+        }
+        return sqlite3_errstr(result_code);
+    }
+
+    void Status::throw_if_error() const
+    {
+        if (!ok())
+        {
+            throw_error(message().c_str(), result_code);
+        }
     }
 
     void Connection::open(const std::string& filename)
@@ -141,6 +681,7 @@ namespace sqlitemm
             check_open_ok(db, result_code);
         }
         sqlite3_extended_result_codes(db, 1);
+        registry = new StatementRegistry();
     }
 
     void Connection::open(const std::u16string& filename)
@@ -149,6 +690,7 @@ namespace sqlitemm
         int result_code = sqlite3_open16(filename.c_str(), &db);
         check_open_ok(db, result_code);
         sqlite3_extended_result_codes(db, 1);
+        registry = new StatementRegistry();
     }
 
     void Connection::open(const std::string& filename, int flags, const std::string& vfs)
@@ -158,6 +700,125 @@ namespace sqlitemm
         int result_code = sqlite3_open_v2(filename.c_str(), &db, flags, vfs_name);
         check_open_ok(db, result_code);
         sqlite3_extended_result_codes(db, 1);
+        registry = new StatementRegistry();
+    }
+
+    void Connection::open(const std::string& filename, const ConnectionOptions& options)
+    {
+        open(filename, options.flags, options.vfs);
+        try
+        {
+            apply_options(options);
+        }
+        catch (...)
+        {
+            close();
+            throw;
+        }
+    }
+
+    void Connection::open_readonly_snapshot(const std::string& filename)
+    {
+        // escape the characters that would otherwise end the path of the URI
+        std::string uri = "file:";
+        for (char c : filename)
+        {
+            if (c == '%' || c == '?' || c == '#')
+            {
+                static const char hex_digits[] = "0123456789ABCDEF";
+                uri += '%';
+                uri += hex_digits[static_cast<unsigned char>(c) >> 4];
+                uri += hex_digits[static_cast<unsigned char>(c) & 0xf];
+            }
+            else
+            {
+                uri += c;
+            }
+        }
+        uri += "?immutable=1";
+
+        open(uri, SQLITE_OPEN_READONLY | SQLITE_OPEN_URI | SQLITE_OPEN_PRIVATECACHE);
+        try
+        {
+            // SQLite limits the size of the mapping to SQLITE_MAX_MMAP_SIZE
+            execute("PRAGMA mmap_size=9223372036854775807;");
+        }
+        catch (...)
+        {
+            close();
+            throw;
+        }
+    }
+
+    void Connection::open_readonly_snapshot(const unsigned char* image, std::size_t size)
+    {
+        open(":memory:", SQLITE_OPEN_READWRITE | SQLITE_OPEN_PRIVATECACHE);
+        // SQLite does not modify an image deserialized as read-only, and
+        // does not free it without SQLITE_DESERIALIZE_FREEONCLOSE
+        int result_code = sqlite3_deserialize(
+            db, "main", const_cast<unsigned char*>(image), static_cast<sqlite3_int64>(size),
+            static_cast<sqlite3_int64>(size), SQLITE_DESERIALIZE_READONLY
+        );
+        try
+        {
+            check_result_ok(db, result_code);
+            // lets SQLite fetch pages from the image rather than copy them
+            execute("PRAGMA mmap_size=9223372036854775807;");
+        }
+        catch (...)
+        {
+            close();
+            throw;
+        }
+    }
+
+    void Connection::apply_options(const ConnectionOptions& options)
+    {
+        if (options.lookaside_slot_size > 0 && options.lookaside_slot_count > 0)
+        {
+            // SQLite rounds the slot size down to a multiple of 8
+            size_t slot_size = static_cast<size_t>(options.lookaside_slot_size) & ~size_t(7);
+            if (options.lookaside_arena)
+            {
+                lookaside_arena = new unsigned char[slot_size * static_cast<size_t>(options.lookaside_slot_count)];
+            }
+            int result_code = sqlite3_db_config(
+                db, SQLITE_DBCONFIG_LOOKASIDE, static_cast<void*>(lookaside_arena),
+                static_cast<int>(slot_size), options.lookaside_slot_count
+            );
+            check_result_ok(db, result_code);
+        }
+
+        std::ostringstream sql;
+        if (options.cache_size)
+        {
+            sql << "PRAGMA cache_size = " << *options.cache_size << ";";
+        }
+        if (options.mmap_size)
+        {
+            sql << "PRAGMA mmap_size = " << *options.mmap_size << ";";
+        }
+        if (options.temp_store)
+        {
+            static const char* const temp_store_names[] = {"DEFAULT", "FILE", "MEMORY"};
+            sql << "PRAGMA temp_store = " << temp_store_names[static_cast<int>(*options.temp_store)] << ";";
+        }
+        if (options.synchronous)
+        {
+            static const char* const synchronous_names[] = {"OFF", "NORMAL", "FULL", "EXTRA"};
+            sql << "PRAGMA synchronous = " << synchronous_names[static_cast<int>(*options.synchronous)] << ";";
+        }
+        if (options.journal_mode)
+        {
+            static const char* const journal_mode_names[] = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+            sql << "PRAGMA journal_mode = " << journal_mode_names[static_cast<int>(*options.journal_mode)] << ";";
+        }
+
+        auto pragmas = sql.str();
+        if (!pragmas.empty())
+        {
+            execute(pragmas);
+        }
     }
 
     void Connection::close() noexcept
@@ -167,23 +828,37 @@ namespace sqlitemm
             return;
         }
 
+        if (registry)
+        {
+            registry->clear_cache();
+            registry->finalize_control_statements();
+        }
+
         int result_code = sqlite3_close(db);
         if (result_code != SQLITE_OK)
         {
             assert(result_code == SQLITE_BUSY);
 
-            for (auto&& stmt_weak_ptr : stmt_ptrs)
+            if (registry)
             {
-                auto stmt_ptr = stmt_weak_ptr.lock();
-                if (stmt_ptr && *stmt_ptr)
-                {
-                    sqlite3_finalize(*stmt_ptr);
-                }
+                registry->finalize_all();
             }
-            stmt_ptrs.clear();
 
-            sqlite3_close(db);
+            result_code = sqlite3_close(db);
         }
+        delete registry;
+        registry = nullptr;
+        // statements finalized on closing still report their profiles
+        delete profiler;
+        profiler = nullptr;
+        // a database connection that failed to close may still use its lookaside slots
+        if (result_code == SQLITE_OK)
+        {
+            delete[] lookaside_arena;
+        }
+        lookaside_arena = nullptr;
+        delete wal_hook;
+        wal_hook = nullptr;
         db = nullptr;
     }
 
@@ -208,20 +883,52 @@ namespace sqlitemm
     Statement Connection::prepare(const std::string& sql)
     {
         assert(db && "database connection must exist");
+        return Statement(prepare_statement(db, sql), registry);
+    }
 
-        sqlite3_stmt* stmt;
-        int result_code = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
-        check_result_ok(db, result_code);
+    Statement Connection::prepare_cached(const std::string& sql)
+    {
+        assert(db && "database connection must exist");
+
+        if (registry->cache_capacity == 0)
+        {
+            return prepare(sql);
+        }
+        return registry->acquire(db, sql);
+    }
 
-        auto stmt_ptr = std::make_shared<sqlite3_stmt*>(stmt);
-        clean_stmt_ptrs();
-        stmt_ptrs.push_back(stmt_ptr);
-        return Statement(stmt_ptr);
+    Script Connection::prepare_script(const std::string& sql)
+    {
+        assert(db && "database connection must exist");
+        return Script(db, registry, sql);
     }
 
-    Transaction Connection::begin_transaction()
+    void Connection::set_statement_cache_capacity(size_t capacity)
     {
-        return Transaction(db);
+        assert(db && "database connection must exist");
+        registry->set_cache_capacity(capacity);
+    }
+
+    size_t Connection::statement_cache_capacity() const noexcept
+    {
+        return registry ? registry->cache_capacity : 0;
+    }
+
+    StatementCacheStats Connection::statement_cache_stats() const noexcept
+    {
+        return registry ? registry->cache_stats : StatementCacheStats{};
+    }
+
+    Transaction Connection::begin_transaction(TransactionMode mode)
+    {
+        assert(db);
+        return Transaction(db, registry, mode);
+    }
+
+    Savepoint Connection::begin_savepoint()
+    {
+        assert(db);
+        return Savepoint(db, registry);
     }
 
     Blob Connection::open_blob(
@@ -239,10 +946,157 @@ namespace sqlitemm
         sqlite3_busy_timeout(db, ms);
     }
 
-    void Connection::clean_stmt_ptrs()
+    void Connection::enable_profiling()
+    {
+        assert(db && "database connection must be open to enable profiling");
+        if (profiler)
+        {
+            return;
+        }
+
+        std::unique_ptr<StatementProfiler> new_profiler(new StatementProfiler());
+        int result_code = sqlite3_trace_v2(db, SQLITE_TRACE_PROFILE, &StatementProfiler::trace, new_profiler.get());
+        check_result_ok(db, result_code);
+        profiler = new_profiler.release();
+    }
+
+    void Connection::disable_profiling() noexcept
+    {
+        if (!profiler)
+        {
+            return;
+        }
+
+        sqlite3_trace_v2(db, 0, nullptr, nullptr);
+        delete profiler;
+        profiler = nullptr;
+    }
+
+    std::vector<StatementProfile> Connection::statement_profiles() const
     {
-        stmt_ptrs.erase(std::remove_if(stmt_ptrs.begin(), stmt_ptrs.end(), [](auto&& p) { return p.expired(); }),
-                        stmt_ptrs.end());
+        return profiler ? profiler->snapshot() : std::vector<StatementProfile>{};
+    }
+
+    DatabaseStatus Connection::database_status(bool reset) const
+    {
+        assert(db && "database connection must be open to retrieve its status");
+        int reset_flag = reset ? 1 : 0;
+        // the lookaside hit and miss counters are reported as the highest value
+        auto status = [this, reset_flag](int op, bool highest_value = false) -> long long {
+            int current = 0;
+            int highest = 0;
+            check_result_ok(db, sqlite3_db_status(db, op, &current, &highest, reset_flag));
+            return highest_value ? highest : current;
+        };
+
+        DatabaseStatus database_status;
+        database_status.cache_hits = status(SQLITE_DBSTATUS_CACHE_HIT);
+        database_status.cache_misses = status(SQLITE_DBSTATUS_CACHE_MISS);
+        database_status.cache_writes = status(SQLITE_DBSTATUS_CACHE_WRITE);
+        database_status.cache_spills = status(SQLITE_DBSTATUS_CACHE_SPILL);
+        database_status.cache_used_bytes = status(SQLITE_DBSTATUS_CACHE_USED);
+        database_status.schema_used_bytes = status(SQLITE_DBSTATUS_SCHEMA_USED);
+        database_status.statement_used_bytes = status(SQLITE_DBSTATUS_STMT_USED);
+        database_status.lookaside_used = status(SQLITE_DBSTATUS_LOOKASIDE_USED);
+        database_status.lookaside_hits = status(SQLITE_DBSTATUS_LOOKASIDE_HIT, true);
+        database_status.lookaside_misses = status(SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, true) +
+                                           status(SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, true);
+        return database_status;
+    }
+
+    CheckpointResult Connection::checkpoint(CheckpointMode mode, const std::string& schema_name)
+    {
+        assert(db && "database connection must be open to run a checkpoint");
+        static const int checkpoint_modes[] = {
+            SQLITE_CHECKPOINT_PASSIVE, SQLITE_CHECKPOINT_FULL, SQLITE_CHECKPOINT_RESTART, SQLITE_CHECKPOINT_TRUNCATE
+        };
+
+        CheckpointResult result;
+        int result_code = sqlite3_wal_checkpoint_v2(
+            db, schema_name.empty() ? nullptr : schema_name.c_str(), checkpoint_modes[static_cast<int>(mode)],
+            &result.wal_frames, &result.checkpointed_frames
+        );
+        if ((result_code & 0xff) == SQLITE_BUSY)
+        {
+            result.busy = true;
+        }
+        else
+        {
+            check_result_ok(db, result_code);
+        }
+        return result;
+    }
+
+    void Connection::set_wal_autocheckpoint(int wal_frames)
+    {
+        assert(db && "database connection must be open to configure checkpoints");
+        check_result_ok(db, sqlite3_wal_autocheckpoint(db, wal_frames > 0 ? wal_frames : 0));
+        delete wal_hook;
+        wal_hook = nullptr;
+    }
+
+    void Connection::set_wal_hook(std::function<void(const char* schema_name, int wal_frames)> hook)
+    {
+        assert(db && "database connection must be open to set a WAL hook");
+        auto new_hook = hook ? new std::function<void(const char*, int)>(std::move(hook)) : nullptr;
+        if (new_hook)
+        {
+            sqlite3_wal_hook(db, [](void* user_data, sqlite3*, const char* schema_name, int wal_frames) noexcept {
+                (*static_cast<std::function<void(const char*, int)>*>(user_data))(schema_name, wal_frames);
+                return SQLITE_OK;
+            }, new_hook);
+        }
+        else
+        {
+            sqlite3_wal_hook(db, nullptr, nullptr);
+        }
+        delete wal_hook;
+        wal_hook = new_hook;
+    }
+
+    void Connection::register_function(
+        const std::string& name,
+        int num_args,
+        int flags,
+        FunctionUserData user_data,
+        void (*scalar_function)(sqlite3_context*, int, sqlite3_value**),
+        void (*step_function)(sqlite3_context*, int, sqlite3_value**),
+        void (*final_function)(sqlite3_context*)
+    )
+    {
+        assert(db && "database connection must be open to create a SQL function");
+        auto result_code = sqlite3_create_function_v2(
+            db, name.c_str(), num_args, SQLITE_UTF8 | flags, user_data.get(),
+            scalar_function, step_function, final_function, user_data ? user_data.get_deleter() : nullptr
+        );
+        // SQLite now owns the user data, destroying it itself if registration failed
+        user_data.release();
+        check_result_ok(db, result_code);
+    }
+
+    void Connection::set_function_error(sqlite3_context* context) noexcept
+    {
+        try
+        {
+            throw;
+        }
+        catch (const Error& e)
+        {
+            sqlite3_result_error(context, e.what(), -1);
+            sqlite3_result_error_code(context, e.code());
+        }
+        catch (const std::bad_alloc&)
+        {
+            sqlite3_result_error_nomem(context);
+        }
+        catch (const std::exception& e)
+        {
+            sqlite3_result_error(context, e.what(), -1);
+        }
+        catch (...)
+        {
+            sqlite3_result_error(context, "unknown exception thrown by SQL function", -1);
+        }
     }
 
     void attach(Connection& connection, const std::string& filename, const std::string& schema_name)
@@ -261,12 +1115,29 @@ namespace sqlitemm
         connection.execute(sql.str());
     }
 
+    void configure_page_cache(int slot_size, int page_count)
+    {
+        assert(slot_size > 0 && page_count > 0);
+        auto arena = new unsigned char[static_cast<size_t>(slot_size) * static_cast<size_t>(page_count)];
+        int result_code = sqlite3_config(SQLITE_CONFIG_PAGECACHE, static_cast<void*>(arena), slot_size, page_count);
+        if (result_code != SQLITE_OK)
+        {
+            delete[] arena;
+            throw_error(sqlite3_errstr(result_code), result_code);
+        }
+    }
+
     Backup::Backup(Connection& source, const std::string& source_database,
                    Connection& destination, const std::string& destination_database)
     {
         backup = sqlite3_backup_init(
             destination.db, destination_database.c_str(), source.db, source_database.c_str()
         );
+        if (!backup)
+        {
+            throw_error(destination.db, sqlite3_errcode(destination.db));
+        }
+        db = destination.db;
     }
 
     bool Backup::step(int num_pages)
@@ -462,6 +1333,25 @@ namespace sqlitemm
             check_result_ok(stmt, result_code);
         }
 
+        void bind_parameter(sqlite3_stmt* stmt, int index, std::string_view value)
+        {
+            // a null pointer would bind NULL rather than empty text
+            const char* content = value.data() ? value.data() : "";
+            int result_code = sqlite3_bind_text64(
+                stmt, index, content, static_cast<sqlite3_uint64>(value.size()), SQLITE_STATIC, SQLITE_UTF8
+            );
+            check_result_ok(stmt, result_code);
+        }
+
+        void bind_parameter(sqlite3_stmt* stmt, int index, BlobView value)
+        {
+            // a null pointer would bind NULL rather than an empty BLOB
+            int result_code = value.data() ?
+                sqlite3_bind_blob64(stmt, index, value.data(), value.size(), SQLITE_STATIC) :
+                sqlite3_bind_zeroblob(stmt, index, 0);
+            check_result_ok(stmt, result_code);
+        }
+
         void bind_parameter(sqlite3_stmt* stmt, int index, const TextValue& value)
         {
             int result_code = sqlite3_bind_text(stmt, index, value.content, value.num_bytes, value.destructor);
@@ -483,20 +1373,6 @@ namespace sqlitemm
         }
     }
 
-    Parameter::Parameter(sqlite3_stmt* stmt, const char* name) : stmt(stmt)
-    {
-        assert(stmt && "prepared statement must not be a null pointer");
-        assert(name && "bind parameter name must not be a null pointer");
-
-        index = sqlite3_bind_parameter_index(stmt, name);
-        if (index == 0)
-        {
-            std::ostringstream ss;
-            ss << "invalid bind parameter name \"" << name << "\"";
-            throw_error(ss.str().c_str(), SQLITE_RANGE);
-        }
-    }
-
     void Parameter::operator=(std::nullptr_t value)
     {
         bind_parameter(stmt, index, value);
@@ -579,7 +1455,15 @@ namespace sqlitemm
 
     void Parameter::operator=(std::string&& value)
     {
-        bind_parameter(stmt, index, std::move(value));
+        if (owned)
+        {
+            owned->text = std::move(value);
+            bind_parameter(stmt, index, owned->text);
+        }
+        else
+        {
+            bind_parameter(stmt, index, std::move(value));
+        }
     }
 
     void Parameter::operator=(const std::u16string& value)
@@ -589,7 +1473,25 @@ namespace sqlitemm
 
     void Parameter::operator=(std::u16string&& value)
     {
-        bind_parameter(stmt, index, std::move(value));
+        if (owned)
+        {
+            owned->text16 = std::move(value);
+            bind_parameter(stmt, index, owned->text16);
+        }
+        else
+        {
+            bind_parameter(stmt, index, std::move(value));
+        }
+    }
+
+    void Parameter::operator=(std::string_view value)
+    {
+        bind_parameter(stmt, index, value);
+    }
+
+    void Parameter::operator=(BlobView value)
+    {
+        bind_parameter(stmt, index, value);
     }
 
     void Parameter::operator=(const char* value)
@@ -612,475 +1514,1089 @@ namespace sqlitemm
         bind_parameter(stmt, index, value);
     }
 
+    Statement::Statement(sqlite3_stmt* stmt, StatementRegistry* registry) noexcept : stmt(stmt)
+    {
+        if (stmt && registry)
+        {
+            registry->add(*this);
+        }
+    }
+
+    Statement::Statement(Statement&& other) noexcept :
+        stmt(other.stmt),
+        cached(other.cached),
+        cache_key(std::move(other.cache_key)),
+        parameter_index(other.parameter_index),
+        parameter_indices(std::move(other.parameter_indices)),
+        owned_text(std::move(other.owned_text))
+    {
+        if (other.registry)
+        {
+            other.registry->transfer(other, *this);
+        }
+        other.stmt = nullptr;
+        other.cached = false;
+    }
+
     Statement& Statement::operator=(Statement&& other) noexcept
     {
-        using std::swap;
-        swap(stmt_ptr, other.stmt_ptr);
-        swap(parameter_index, other.parameter_index);
+        if (this != &other)
+        {
+            finalize();
+            stmt = other.stmt;
+            cached = other.cached;
+            cache_key = std::move(other.cache_key);
+            parameter_index = other.parameter_index;
+            parameter_indices = std::move(other.parameter_indices);
+            owned_text = std::move(other.owned_text);
+            if (other.registry)
+            {
+                other.registry->transfer(other, *this);
+            }
+            other.stmt = nullptr;
+            other.cached = false;
+            other.parameter_index = 1;
+            other.parameter_indices.clear();
+            other.owned_text.clear();
+        }
         return *this;
     }
 
     Statement& Statement::operator<<(std::nullptr_t value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(bool value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(char value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(signed char value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(unsigned char value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(short value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(unsigned short value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(int value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(unsigned int value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(long value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(unsigned long value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
     Statement& Statement::operator<<(long long value)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(unsigned long long value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(float value)
+    {
+        bind_parameter(stmt, parameter_index, value);
         ++parameter_index;
         return *this;
     }
 
-    Statement& Statement::operator<<(unsigned long long value)
+    Statement& Statement::operator<<(double value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(const std::string& value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(std::string&& value)
+    {
+        if (auto owned = owned_text_for(parameter_index))
+        {
+            owned->text = std::move(value);
+            bind_parameter(stmt, parameter_index, owned->text);
+        }
+        else
+        {
+            bind_parameter(stmt, parameter_index, std::move(value));
+        }
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(const std::u16string& value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(std::u16string&& value)
+    {
+        if (auto owned = owned_text_for(parameter_index))
+        {
+            owned->text16 = std::move(value);
+            bind_parameter(stmt, parameter_index, owned->text16);
+        }
+        else
+        {
+            bind_parameter(stmt, parameter_index, std::move(value));
+        }
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(std::string_view value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(BlobView value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(const char* value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(const BlobValue& value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(const TextValue& value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    Statement& Statement::operator<<(const ZeroBlob& value)
+    {
+        bind_parameter(stmt, parameter_index, value);
+        ++parameter_index;
+        return *this;
+    }
+
+    bool Statement::finalize() noexcept
+    {
+        if (!stmt)
+        {
+            return true;
+        }
+
+        StatementRegistry* owner = registry;
+        if (owner)
+        {
+            owner->remove(*this);
+            if (cached)
+            {
+                return owner->release(*this);
+            }
+        }
+
+        int result_code = sqlite3_finalize(stmt);
+        stmt = nullptr;
+        cached = false;
+        parameter_indices.clear();
+        owned_text.clear();
+        return result_code == SQLITE_OK;
+    }
+
+    Parameter Statement::parameter(std::string_view name)
+    {
+        assert(stmt && "prepared statement must not be a null pointer");
+
+        if (parameter_indices.empty())
+        {
+            // the names are owned by the prepared statement, so they remain valid until it is finalized
+            int parameter_count = sqlite3_bind_parameter_count(stmt);
+            parameter_indices.reserve(parameter_count);
+            for (int index = 1; index <= parameter_count; ++index)
+            {
+                if (auto parameter_name = sqlite3_bind_parameter_name(stmt, index))
+                {
+                    parameter_indices.emplace_back(parameter_name, index);
+                }
+            }
+            std::sort(parameter_indices.begin(), parameter_indices.end());
+        }
+
+        auto found = std::lower_bound(
+            parameter_indices.begin(),
+            parameter_indices.end(),
+            name,
+            [](const std::pair<std::string_view, int>& entry, std::string_view name) { return entry.first < name; }
+        );
+        if (found == parameter_indices.end() || found->first != name)
+        {
+            std::ostringstream ss;
+            ss << "invalid bind parameter name \"" << name << "\"";
+            throw_error(ss.str().c_str(), SQLITE_RANGE);
+        }
+        return Parameter(stmt, found->second, owned_text_for(found->second));
+    }
+
+    void Statement::check_parameter_count(int num_args) const
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        int parameter_count = sqlite3_bind_parameter_count(stmt);
+        if (num_args != parameter_count)
+        {
+            std::ostringstream ss;
+            ss << "cannot bind " << num_args << " values to a statement with " << parameter_count << " parameters";
+            throw_error(ss.str().c_str(), SQLITE_RANGE);
+        }
     }
 
-    Statement& Statement::operator<<(float value)
+    void Statement::throw_bind_error(int result_code) const
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        throw_error(stmt, result_code);
     }
 
-    Statement& Statement::operator<<(double value)
+    Parameter::OwnedText* Statement::owned_text_for(int index)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        assert(stmt);
+        if (owned_text.empty())
+        {
+            owned_text.resize(static_cast<size_t>(sqlite3_bind_parameter_count(stmt)));
+        }
+        if (index < 1 || static_cast<size_t>(index) > owned_text.size())
+        {
+            return nullptr;
+        }
+        return &owned_text[index - 1];
     }
 
-    Statement& Statement::operator<<(const std::string& value)
+    void Statement::clear_owned_text() noexcept
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        for (auto& owned : owned_text)
+        {
+            owned.clear();
+        }
     }
 
-    Statement& Statement::operator<<(std::string&& value)
+    void Statement::execute()
     {
-        bind_parameter(*stmt_ptr, parameter_index, std::move(value));
-        ++parameter_index;
-        return *this;
+        assert(stmt);
+        int result_code = sqlite3_step(stmt);
+        if (result_code != SQLITE_DONE && result_code != SQLITE_ROW)
+        {
+            throw_error(stmt, result_code);
+        }
     }
 
-    Statement& Statement::operator<<(const std::u16string& value)
+    Status Statement::try_execute() noexcept
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        assert(stmt);
+        return Status(sqlite3_step(stmt), sqlite3_db_handle(stmt));
     }
 
-    Statement& Statement::operator<<(std::u16string&& value)
+    Result Statement::execute_query(bool strict_typing)
     {
-        bind_parameter(*stmt_ptr, parameter_index, std::move(value));
-        ++parameter_index;
-        return *this;
+        assert(stmt);
+        return Result(stmt, strict_typing);
     }
 
-    Statement& Statement::operator<<(const char* value)
+    void Statement::reset(bool clear_bindings)
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        assert(stmt);
+        int result_code = sqlite3_reset(stmt);
+        check_result_ok(stmt, result_code);
+        parameter_index = 1;
+        if (clear_bindings)
+        {
+            this->clear_bindings();
+        }
     }
 
-    Statement& Statement::operator<<(const BlobValue& value)
+    Status Statement::try_reset(bool clear_bindings) noexcept
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        assert(stmt);
+        int result_code = sqlite3_reset(stmt);
+        parameter_index = 1;
+        if (clear_bindings)
+        {
+            this->clear_bindings();
+        }
+        return Status(result_code, sqlite3_db_handle(stmt));
     }
 
-    Statement& Statement::operator<<(const TextValue& value)
+    void Statement::clear_bindings()
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        sqlite3_clear_bindings(stmt);
+        clear_owned_text();
     }
 
-    Statement& Statement::operator<<(const ZeroBlob& value)
+    Statement::Batch::Batch(Statement& statement, size_t commit_every) :
+        statement(statement), commit_every(commit_every), start_time(steady_clock_nanoseconds())
     {
-        bind_parameter(*stmt_ptr, parameter_index, value);
-        ++parameter_index;
-        return *this;
+        assert(statement.stmt);
+        if (!sqlite3_get_autocommit(sqlite3_db_handle(statement.stmt)))
+        {
+            // leave committing to the caller's transaction
+            this->commit_every = 0;
+        }
     }
 
-    bool Statement::finalize() noexcept
+    Statement::Batch::~Batch()
     {
-        if (stmt_ptr && *stmt_ptr)
+        if (in_transaction)
         {
-            int result_code = sqlite3_finalize(*stmt_ptr);
-            *stmt_ptr = nullptr;
-            return result_code == SQLITE_OK;
+            statement.registry->execute_control(sqlite3_db_handle(statement.stmt), StatementRegistry::rollback);
         }
-        return true;
     }
 
-    void Statement::execute()
+    void Statement::Batch::execute_row()
     {
-        assert(stmt_ptr && *stmt_ptr);
-        int result_code = sqlite3_step(*stmt_ptr);
-        if (result_code != SQLITE_DONE && result_code != SQLITE_ROW)
+        sqlite3_stmt* stmt = statement.stmt;
+        if (commit_every > 0 && !in_transaction)
         {
-            throw_error(*stmt_ptr, result_code);
+            // take the write lock up front so that the batch cannot fail to upgrade its lock part way through
+            statement.registry->check_execute_control(sqlite3_db_handle(stmt), StatementRegistry::begin_immediate);
+            in_transaction = true;
         }
-    }
 
-    Result Statement::execute_query(bool strict_typing)
-    {
-        assert(stmt_ptr && *stmt_ptr);
-        return Result(*stmt_ptr, strict_typing);
-    }
+        int result_code = sqlite3_step(stmt);
+        if (result_code != SQLITE_DONE && result_code != SQLITE_ROW)
+        {
+            throw_error(stmt, result_code);
+        }
+        sqlite3_reset(stmt);
+        statement.parameter_index = 1;
+        ++stats.rows;
 
-    void Statement::reset(bool clear_bindings)
-    {
-        assert(stmt_ptr && *stmt_ptr);
-        int result_code = sqlite3_reset(*stmt_ptr);
-        check_result_ok(*stmt_ptr, result_code);
-        parameter_index = 1;
-        if (clear_bindings)
+        if (in_transaction && stats.rows % commit_every == 0)
         {
-            this->clear_bindings();
+            statement.registry->check_execute_control(sqlite3_db_handle(stmt), StatementRegistry::commit);
+            in_transaction = false;
+            ++stats.commits;
         }
     }
 
-    void Statement::clear_bindings()
+    BatchStats Statement::Batch::finish()
     {
-        sqlite3_clear_bindings(*stmt_ptr);
+        if (in_transaction)
+        {
+            statement.registry->check_execute_control(sqlite3_db_handle(statement.stmt), StatementRegistry::commit);
+            in_transaction = false;
+            ++stats.commits;
+        }
+        stats.seconds = (steady_clock_nanoseconds() - start_time) / 1e9;
+        return stats;
     }
 
     Result& Result::operator>>(bool& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<bool>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(char& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<char>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(signed char& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<signed char>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(unsigned char& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<unsigned char>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(short& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<short>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(unsigned short& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<unsigned short>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(int& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<int>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(unsigned int& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<unsigned int>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(long& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<long>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(unsigned long& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<unsigned long>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(long long& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<long long>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(unsigned long long& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<unsigned long long>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(float& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<float>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(double& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = static_cast<double>((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(std::string& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = std::string((*this)[counter++]);
         return *this;
     }
 
     Result& Result::operator>>(std::u16string& value)
     {
-        assert(counter < column_count);
+        assert(counter < num_columns);
         value = std::u16string((*this)[counter++]);
         return *this;
     }
 
+    void Result::check_column_type(int index, int expected_column_type, int column_type) const
+    {
+        if (column_type == 0)
+        {
+            column_type = sqlite3_column_type(stmt, index);
+        }
+        strict_type_check(strict_typing, column_type, expected_column_type);
+    }
+
+    size_t Result::fetch_columns(ColumnBatch& batch, size_t batch_size)
+    {
+        assert(stmt);
+
+        auto& columns = batch.columns;
+        int count = column_count();
+        if (batch.inferred_types && columns.size() != static_cast<size_t>(count))
+        {
+            columns.clear();
+        }
+        if (!columns.empty() && columns.size() != static_cast<size_t>(count))
+        {
+            std::ostringstream ss;
+            ss << "cannot fetch " << count << " columns into a batch with " << columns.size() << " columns";
+            throw_error(ss.str().c_str(), SQLITE_RANGE);
+        }
+
+        for (auto& column : columns)
+        {
+            column.clear(batch_size);
+        }
+        batch.num_rows = 0;
+
+        // without checking, stepping once more would restart the query
+        while (batch.num_rows < batch_size && !exhausted && step())
+        {
+            if (columns.empty())
+            {
+                columns.resize(count);
+                for (int index = 0; index < count; ++index)
+                {
+                    int field_type = sqlite3_column_type(stmt, index);
+                    columns[index].column_type = (field_type != SQLITE_NULL)
+                        ? field_type
+                        : get_affinity_column_type(sqlite3_column_decltype(stmt, index));
+                    columns[index].clear(batch_size);
+                }
+            }
+
+            if (strict_typing)
+            {
+                // checked before any field is appended so that a mismatch leaves the columns of equal length
+                for (int index = 0; index < count; ++index)
+                {
+                    int field_type = sqlite3_column_type(stmt, index);
+                    if (field_type != SQLITE_NULL)
+                    {
+                        strict_type_check(strict_typing, field_type, columns[index].column_type);
+                    }
+                }
+            }
+
+            size_t row = batch.num_rows;
+            for (int index = 0; index < count; ++index)
+            {
+                auto& column = columns[index];
+                bool is_null = sqlite3_column_type(stmt, index) == SQLITE_NULL;
+                if (is_null)
+                {
+                    column.null_bits[row / 64] |= std::uint64_t(1) << (row % 64);
+                }
+
+                switch (column.column_type)
+                {
+                case SQLITE_INTEGER:
+                    column.integer_values.push_back(is_null ? 0 : sqlite3_column_int64(stmt, index));
+                    break;
+                case SQLITE_FLOAT:
+                    column.real_values.push_back(is_null ? 0.0 : sqlite3_column_double(stmt, index));
+                    break;
+                default:
+                    if (!is_null)
+                    {
+                        auto value = static_cast<const unsigned char*>(
+                            (column.column_type == SQLITE_TEXT) ? static_cast<const void*>(sqlite3_column_text(stmt, index))
+                                                                : sqlite3_column_blob(stmt, index)
+                        );
+                        auto num_bytes = static_cast<size_t>(sqlite3_column_bytes(stmt, index));
+                        if (value)
+                        {
+                            column.byte_values.insert(column.byte_values.end(), value, value + num_bytes);
+                        }
+                    }
+                    column.byte_offsets.push_back(column.byte_values.size());
+                    break;
+                }
+            }
+            ++batch.num_rows;
+        }
+        return batch.num_rows;
+    }
+
+    ColumnBatch::ColumnBatch(const std::vector<int>& column_types) : columns(column_types.size()), inferred_types(false)
+    {
+        for (size_t index = 0; index < column_types.size(); ++index)
+        {
+            assert(column_types[index] == SQLITE_INTEGER || column_types[index] == SQLITE_FLOAT ||
+                   column_types[index] == SQLITE_TEXT || column_types[index] == SQLITE_BLOB);
+            columns[index].column_type = column_types[index];
+        }
+    }
+
+    void ColumnBatch::clear()
+    {
+        for (auto& column : columns)
+        {
+            column.clear(0);
+        }
+        if (inferred_types)
+        {
+            columns.clear();
+        }
+        num_rows = 0;
+    }
+
+    void ColumnBatch::Column::clear(size_t batch_size)
+    {
+        null_bits.assign((batch_size + 63) / 64, 0);
+        integer_values.clear();
+        real_values.clear();
+        byte_offsets.clear();
+        byte_values.clear();
+        switch (column_type)
+        {
+        case SQLITE_INTEGER:
+            integer_values.reserve(batch_size);
+            break;
+        case SQLITE_FLOAT:
+            real_values.reserve(batch_size);
+            break;
+        default:
+            byte_offsets.reserve(batch_size + 1);
+            byte_offsets.push_back(0);
+            break;
+        }
+    }
+
+    int Result::column_index(std::string_view name) const
+    {
+        if (column_indices.empty())
+        {
+            // the names are owned by column_info, whose elements stay in place once retrieved
+            auto& info = columns();
+            column_indices.reserve(info.size());
+            for (size_t index = 0; index < info.size(); ++index)
+            {
+                column_indices.emplace_back(info[index].name, static_cast<int>(index));
+            }
+            std::sort(column_indices.begin(), column_indices.end());
+        }
+
+        auto found = std::lower_bound(
+            column_indices.begin(),
+            column_indices.end(),
+            name,
+            [](const std::pair<std::string_view, int>& entry, std::string_view name) { return entry.first < name; }
+        );
+        if (found == column_indices.end() || found->first != name)
+        {
+            std::ostringstream ss;
+            ss << "no such column \"" << name << "\" in result set";
+            throw_error(ss.str().c_str(), SQLITE_RANGE);
+        }
+        return found->second;
+    }
+
+    const std::vector<ColumnInfo>& Result::columns() const
+    {
+        assert(stmt);
+
+        if (column_info.empty())
+        {
+            // copy the names since SQLite may invalidate them should the statement be reprepared
+            auto to_string = [](const char* value) { return value ? std::string(value) : std::string(); };
+            int count = column_count();
+            column_info.reserve(count);
+            for (int index = 0; index < count; ++index)
+            {
+                ColumnInfo info;
+                info.name = to_string(sqlite3_column_name(stmt, index));
+                info.declared_type = to_string(sqlite3_column_decltype(stmt, index));
+#ifdef SQLITE_ENABLE_COLUMN_METADATA
+                info.database_name = to_string(sqlite3_column_database_name(stmt, index));
+                info.table_name = to_string(sqlite3_column_table_name(stmt, index));
+                info.origin_name = to_string(sqlite3_column_origin_name(stmt, index));
+#endif
+                column_info.push_back(std::move(info));
+            }
+        }
+        return column_info;
+    }
+
+    Result& Result::operator>>(std::string_view& value)
+    {
+        assert(counter < num_columns);
+        value = static_cast<std::string_view>((*this)[counter++]);
+        return *this;
+    }
+
+    Result& Result::operator>>(BlobView& value)
+    {
+        assert(counter < num_columns);
+        value = static_cast<BlobView>((*this)[counter++]);
+        return *this;
+    }
+
+    std::string_view Result::text_view(int index) const
+    {
+        const void* value = sqlite3_column_text(stmt, index);
+        auto num_bytes = static_cast<size_t>(sqlite3_column_bytes(stmt, index));
+#ifdef SQLITEMM_DEBUG_VIEWS
+        value = value ? track_view(value, num_bytes) : nullptr;
+#endif
+        return value ? std::string_view(static_cast<const char*>(value), num_bytes) : std::string_view();
+    }
+
+    BlobView Result::blob_view(int index) const
+    {
+        auto value = sqlite3_column_blob(stmt, index);
+        auto num_bytes = static_cast<size_t>(sqlite3_column_bytes(stmt, index));
+#ifdef SQLITEMM_DEBUG_VIEWS
+        value = value ? track_view(value, num_bytes) : nullptr;
+#endif
+        return value ? BlobView(value, num_bytes) : BlobView();
+    }
+
+#ifdef SQLITEMM_DEBUG_VIEWS
+    const void* Result::track_view(const void* value, size_t num_bytes) const
+    {
+        std::unique_ptr<unsigned char[]> copy(new unsigned char[num_bytes > 0 ? num_bytes : 1]);
+        std::memcpy(copy.get(), value, num_bytes);
+        view_copies.emplace_back(std::move(copy), num_bytes);
+        return view_copies.back().first.get();
+    }
+
+    void Result::invalidate_views() noexcept
+    {
+        // free the copies made two rows ago, then poison those of the current row
+        stale_view_copies.clear();
+        for (auto&& view_copy : view_copies)
+        {
+            std::memset(view_copy.first.get(), 0xdd, view_copy.second);
+        }
+        stale_view_copies.swap(view_copies);
+    }
+#endif
+
     bool Result::step()
+    {
+        auto status = try_step();
+        if (!status.ok())
+        {
+            throw_error(stmt, status.code());
+        }
+        return status.has_row();
+    }
+
+    Status Result::try_step() noexcept
     {
         assert(stmt);
 
+#ifdef SQLITEMM_DEBUG_VIEWS
+        invalidate_views();
+#endif
+
         int result_code = sqlite3_step(stmt);
         switch (result_code)
         {
         case SQLITE_ROW:
             counter = 0;
-            if (column_count == 0)
+            exhausted = false;
+            if (num_columns == 0)
             {
-                column_count = sqlite3_column_count(stmt);
+                num_columns = sqlite3_column_count(stmt);
             }
-            return true;
+            break;
         case SQLITE_DONE:
-            return false;
+            exhausted = true;
+            break;
         default:
-            throw_error(stmt, result_code);
-            return false;
+            break;
         }
+        return Status(result_code, sqlite3_db_handle(stmt));
+    }
+
+    void ResultField::check_column_type(int expected_column_type) const
+    {
+        strict_type_check(strict_typing, type(), expected_column_type);
     }
 
     ResultField::operator bool() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return sqlite3_column_int(stmt, index) != 0;
     }
 
     ResultField::operator char() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<char>(sqlite3_column_int(stmt, index));
     }
 
     ResultField::operator signed char() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<signed char>(sqlite3_column_int(stmt, index));
     }
 
     ResultField::operator unsigned char() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<unsigned char>(sqlite3_column_int(stmt, index));
     }
 
     ResultField::operator short() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<short>(sqlite3_column_int(stmt, index));
     }
 
     ResultField::operator unsigned short() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<unsigned short>(sqlite3_column_int(stmt, index));
     }
 
     ResultField::operator int() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return sqlite3_column_int(stmt, index);
     }
 
     ResultField::operator unsigned int() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<unsigned int>(sqlite3_column_int64(stmt, index));
     }
 
     ResultField::operator long() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<long>(sqlite3_column_int64(stmt, index));
     }
 
     ResultField::operator unsigned long() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<unsigned long>(sqlite3_column_int64(stmt, index));
     }
 
     ResultField::operator long long() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return sqlite3_column_int64(stmt, index);
     }
 
     ResultField::operator unsigned long long() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_INTEGER);
+        expect_column_type(SQLITE_INTEGER);
         return static_cast<unsigned long long>(sqlite3_column_int64(stmt, index));
     }
 
     ResultField::operator float() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_FLOAT);
+        expect_column_type(SQLITE_FLOAT);
         return static_cast<float>(sqlite3_column_double(stmt, index));
     }
 
     ResultField::operator double() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_FLOAT);
+        expect_column_type(SQLITE_FLOAT);
         return sqlite3_column_double(stmt, index);
     }
 
     ResultField::operator std::string() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_TEXT);
+        expect_column_type(SQLITE_TEXT);
         const unsigned char* value = sqlite3_column_text(stmt, index);
         return std::string(value, value + sqlite3_column_bytes(stmt, index));
     }
 
     ResultField::operator std::u16string() const
     {
-        strict_type_check(strict_typing, column_type, SQLITE_TEXT);
+        expect_column_type(SQLITE_TEXT);
         auto value = static_cast<const char16_t*>(sqlite3_column_text16(stmt, index));
         return std::u16string(value, value + sqlite3_column_bytes16(stmt, index) / sizeof(char16_t));
     }
 
-    Transaction::Transaction(sqlite3* db) : db(db)
+    ResultField::operator std::string_view() const
+    {
+        expect_column_type(SQLITE_TEXT);
+        return result->text_view(index);
+    }
+
+    ResultField::operator BlobView() const
+    {
+        expect_column_type(SQLITE_BLOB);
+        return result->blob_view(index);
+    }
+
+    Transaction::Transaction(sqlite3* db, StatementRegistry* registry, TransactionMode mode) :
+        db(db), registry(registry), mode(mode)
     {
         begin();
     }
 
     void Transaction::begin()
     {
-        int result_code = sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr);
-        check_result_ok(db, result_code);
+        switch (mode)
+        {
+        case TransactionMode::Immediate:
+            registry->check_execute_control(db, StatementRegistry::begin_immediate);
+            break;
+        case TransactionMode::Exclusive:
+            registry->check_execute_control(db, StatementRegistry::begin_exclusive);
+            break;
+        default:
+            registry->check_execute_control(db, StatementRegistry::begin_deferred);
+            break;
+        }
         committed = false;
     }
 
     void Transaction::commit()
     {
-        int result_code = sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
-        check_result_ok(db, result_code);
+        registry->check_execute_control(db, StatementRegistry::commit);
         committed = true;
     }
 
     void Transaction::rollback() noexcept
     {
-        if (!sqlite3_get_autocommit(db))
+        if (db && !sqlite3_get_autocommit(db))
+        {
+            registry->execute_control(db, StatementRegistry::rollback);
+        }
+    }
+
+    Savepoint::Savepoint(sqlite3* db, StatementRegistry* registry) : db(db), registry(registry)
+    {
+        begin();
+    }
+
+    void Savepoint::begin()
+    {
+        assert(!active && "savepoint must be released or rolled back before it is begun again");
+        registry->check_execute_control(db, StatementRegistry::savepoint);
+        active = true;
+    }
+
+    void Savepoint::release()
+    {
+        assert(active && "savepoint must be active to be released");
+        registry->check_execute_control(db, StatementRegistry::release_savepoint);
+        active = false;
+    }
+
+    void Savepoint::rollback() noexcept
+    {
+        if (active)
+        {
+            // ROLLBACK TO leaves the savepoint on the stack, so it must then be released
+            if (registry->execute_control(db, StatementRegistry::rollback_to_savepoint) == SQLITE_OK)
+            {
+                registry->execute_control(db, StatementRegistry::release_savepoint);
+            }
+            active = false;
+        }
+    }
+
+    Script::Script(sqlite3* db, StatementRegistry* registry, const std::string& sql) :
+        db(db), registry(registry), sql(sql)
+    {
+    }
+
+    void Script::prepare_all()
+    {
+        while (prepare_next()) {}
+    }
+
+    bool Script::prepare_next()
+    {
+        assert(db && "database connection must exist");
+
+        // whitespace and comments between statements prepare to a null statement
+        while (prepared_length < sql.size())
         {
-            sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+            const char* begin = sql.c_str() + prepared_length;
+            const char* tail = nullptr;
+            sqlite3_stmt* stmt = nullptr;
+            int result_code = sqlite3_prepare_v3(
+                db, begin, static_cast<int>(sql.size() - prepared_length), SQLITE_PREPARE_PERSISTENT, &stmt, &tail
+            );
+            check_result_ok(db, result_code);
+            prepared_length += static_cast<size_t>(tail - begin);
+            if (stmt)
+            {
+                try
+                {
+                    statements.push_back(Statement(stmt, registry));
+                }
+                catch (...)
+                {
+                    // the temporary statement has finalized stmt, so the statement must be prepared again
+                    prepared_length = static_cast<size_t>(begin - sql.c_str());
+                    throw;
+                }
+                return true;
+            }
         }
+        return false;
+    }
+
+    void Script::step_to_completion(Statement& statement)
+    {
+        Status status;
+        while ((status = statement.try_execute()).has_row()) {}
+        status.throw_if_error();
     }
 }
@@ -0,0 +1,139 @@
+/************************************************************************************************************
+ * SQLitemm asynchronous connection source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_async.hpp"
+
+namespace sqlitemm
+{
+    namespace
+    {
+        // number of times the worker polls an empty queue before going to sleep
+        constexpr int idle_spin_count = 64;
+    }
+
+    AsyncConnection::AsyncConnection(const std::string& filename, int flags, const std::string& vfs,
+                                     size_t statement_cache_capacity) :
+        conn(filename, flags, vfs)
+    {
+        conn.set_statement_cache_capacity(statement_cache_capacity);
+        worker = std::thread(&AsyncConnection::run, this);
+    }
+
+    AsyncConnection::~AsyncConnection()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping.store(true);
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    // Producers link nodes in with a single atomic exchange, so that
+    // submission is wait-free for them. The worker is only woken through the
+    // condition variable if it has announced that it is going to sleep: since
+    // both sides use sequentially consistent operations, either the producer
+    // sees worker_sleeping set, or the worker sees the new head before waiting.
+    void AsyncConnection::enqueue(Node* node) noexcept
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = head.exchange(node);
+        previous->next.store(node, std::memory_order_release);
+        if (worker_sleeping.load())
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            wake.notify_one();
+        }
+    }
+
+    // Returns nullptr both when the queue is empty, and when a producer has
+    // exchanged the head but not yet linked its node in, in which case
+    // queue_empty() is false and the worker should try again.
+    AsyncConnection::Node* AsyncConnection::dequeue() noexcept
+    {
+        Node* current = tail;
+        Node* next = current->next.load(std::memory_order_acquire);
+        if (current == &stub)
+        {
+            if (!next)
+            {
+                return nullptr;
+            }
+            tail = next;
+            current = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next)
+        {
+            tail = next;
+            return current;
+        }
+        if (current != head.load())
+        {
+            return nullptr;
+        }
+        // current is the only node left, so the stub is queued behind it to
+        // take its place as the tail
+        enqueue(&stub);
+        next = current->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            tail = next;
+            return current;
+        }
+        return nullptr;
+    }
+
+    bool AsyncConnection::queue_empty() const noexcept
+    {
+        return tail == &stub && head.load() == &stub;
+    }
+
+    void AsyncConnection::run() noexcept
+    {
+        for (;;)
+        {
+            // run queued work back to back, only backing off once the queue
+            // has stayed empty for a while
+            int idle_count = 0;
+            while (idle_count < idle_spin_count)
+            {
+                if (Node* node = dequeue())
+                {
+                    if (node != &stub)
+                    {
+                        node->run(conn);
+                        delete node;
+                    }
+                    idle_count = 0;
+                }
+                else
+                {
+                    ++idle_count;
+                    std::this_thread::yield();
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            worker_sleeping.store(true);
+            wake.wait(lock, [this] { return !queue_empty() || stopping.load(); });
+            worker_sleeping.store(false);
+            if (queue_empty() && stopping.load())
+            {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/************************************************************************************************************
+ * SQLitemm backup job source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_backup_job.hpp"
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <utility>
+#include "sqlite3.h"
+
+namespace sqlitemm
+{
+    BackupJob::BackupJob(Connection& source, const std::string& source_database,
+                         Connection& destination, const std::string& destination_database,
+                         BackupJobOptions options) :
+        backup(source, source_database, destination, destination_database),
+        options(std::move(options)),
+        status(promise.get_future().share())
+    {
+        assert(this->options.min_pages_per_step > 0 && "backup job must copy at least one page per step");
+        assert(this->options.max_pages_per_step >= this->options.min_pages_per_step);
+        thread = std::thread(&BackupJob::run, this);
+    }
+
+    BackupJob::~BackupJob()
+    {
+        cancel();
+        thread.join();
+    }
+
+    void BackupJob::cancel() noexcept
+    {
+        std::lock_guard<std::mutex> lock(cancel_mutex);
+        cancelled = true;
+        cancel_requested.notify_all();
+    }
+
+    void BackupJob::run() noexcept
+    {
+        try
+        {
+            auto result = run_steps();
+            // finish the backup before the result is reported so that the destination is ready for use
+            backup.close();
+            promise.set_value(result);
+        }
+        catch (...)
+        {
+            backup.close();
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    BackupStatus BackupJob::run_steps()
+    {
+        int pages_per_step = options.min_pages_per_step;
+        auto backoff = options.min_backoff;
+        while (!cancelled)
+        {
+            bool more_pages;
+            try
+            {
+                more_pages = backup.step(pages_per_step);
+            }
+            catch (const Error& e)
+            {
+                int primary_code = e.code() & 0xff;
+                if (primary_code != SQLITE_BUSY && primary_code != SQLITE_LOCKED)
+                {
+                    throw;
+                }
+
+                // the source is in use by a writer: retry with small steps after backing off
+                pages_per_step = options.min_pages_per_step;
+                if (!pause(backoff))
+                {
+                    break;
+                }
+                backoff = std::min(backoff * 2, options.max_backoff);
+                continue;
+            }
+
+            pages_remaining = backup.pages_remaining();
+            page_count = backup.page_count();
+            if (options.progress_callback)
+            {
+                options.progress_callback(progress());
+            }
+            if (!more_pages)
+            {
+                return BackupStatus::Completed;
+            }
+
+            pages_per_step = std::min(pages_per_step * 2, options.max_pages_per_step);
+            backoff = options.min_backoff;
+            if (options.step_interval.count() > 0 && !pause(options.step_interval))
+            {
+                break;
+            }
+        }
+        return BackupStatus::Cancelled;
+    }
+
+    bool BackupJob::pause(std::chrono::milliseconds duration)
+    {
+        std::unique_lock<std::mutex> lock(cancel_mutex);
+        return !cancel_requested.wait_for(lock, duration, [this] { return cancelled.load(); });
+    }
+}
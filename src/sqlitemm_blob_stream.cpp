@@ -0,0 +1,317 @@
+/************************************************************************************************************
+ * SQLitemm blob stream source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_blob_stream.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace sqlitemm
+{
+    namespace
+    {
+        long read_fd(int fd, void* buffer, size_t num_bytes) noexcept
+        {
+#ifdef _WIN32
+            return _read(fd, buffer, static_cast<unsigned int>(num_bytes));
+#else
+            return static_cast<long>(::read(fd, buffer, num_bytes));
+#endif
+        }
+
+        long write_fd(int fd, const void* buffer, size_t num_bytes) noexcept
+        {
+#ifdef _WIN32
+            return _write(fd, buffer, static_cast<unsigned int>(num_bytes));
+#else
+            return static_cast<long>(::write(fd, buffer, num_bytes));
+#endif
+        }
+
+        void write_all(int fd, const char* buffer, size_t num_bytes)
+        {
+            while (num_bytes > 0)
+            {
+                long num_written = write_fd(fd, buffer, num_bytes);
+                if (num_written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "could not write to file descriptor");
+                }
+                buffer += num_written;
+                num_bytes -= static_cast<size_t>(num_written);
+            }
+        }
+    }
+
+    BlobStreamBuf::BlobStreamBuf(Blob& blob, size_t buffer_size) :
+        blob(blob), buffer(new char[buffer_size > 0 ? buffer_size : 1]), buffer_size(buffer_size > 0 ? buffer_size : 1)
+    {
+        blob_size = blob.size();
+    }
+
+    BlobStreamBuf::~BlobStreamBuf()
+    {
+        try
+        {
+            flush_put_area();
+        }
+        catch (...)
+        {
+            // destructors must not throw
+        }
+    }
+
+    void BlobStreamBuf::reopen(size_t row)
+    {
+        flush_put_area();
+        setg(nullptr, nullptr, nullptr);
+        blob.reopen(row);
+        blob_size = blob.size();
+        position = 0;
+    }
+
+    BlobStreamBuf::int_type BlobStreamBuf::underflow()
+    {
+        if (gptr() < egptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        flush_put_area();
+        end_get_area();
+        if (position >= blob_size)
+        {
+            return traits_type::eof();
+        }
+
+        size_t num_bytes = std::min(buffer_size, blob_size - position);
+        blob.read(buffer.get(), num_bytes, position);
+        setg(buffer.get(), buffer.get(), buffer.get() + num_bytes);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    BlobStreamBuf::int_type BlobStreamBuf::overflow(int_type ch)
+    {
+        flush_put_area();
+        end_get_area();
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            return traits_type::not_eof(ch);
+        }
+        if (position >= blob_size)
+        {
+            // the blob cannot grow
+            return traits_type::eof();
+        }
+
+        setp(buffer.get(), buffer.get() + std::min(buffer_size, blob_size - position));
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    int BlobStreamBuf::sync()
+    {
+        flush_put_area();
+        return 0;
+    }
+
+    std::streamsize BlobStreamBuf::showmanyc()
+    {
+        size_t current = offset();
+        return (current < blob_size) ? static_cast<std::streamsize>(blob_size - current) : -1;
+    }
+
+    std::streamsize BlobStreamBuf::xsgetn(char* s, std::streamsize count)
+    {
+        std::streamsize num_copied = 0;
+        std::streamsize num_buffered = egptr() - gptr();
+        if (num_buffered > 0)
+        {
+            num_copied = std::min(num_buffered, count);
+            std::memcpy(s, gptr(), static_cast<size_t>(num_copied));
+            gbump(static_cast<int>(num_copied));
+        }
+
+        auto num_remaining = static_cast<size_t>(count - num_copied);
+        if (num_remaining < buffer_size)
+        {
+            return num_copied + std::streambuf::xsgetn(s + num_copied, count - num_copied);
+        }
+
+        // large reads go directly from the blob to the destination
+        flush_put_area();
+        end_get_area();
+        size_t num_bytes = (position < blob_size) ? std::min(num_remaining, blob_size - position) : 0;
+        if (num_bytes > 0)
+        {
+            blob.read(s + num_copied, num_bytes, position);
+            position += num_bytes;
+        }
+        return num_copied + static_cast<std::streamsize>(num_bytes);
+    }
+
+    std::streamsize BlobStreamBuf::xsputn(const char* s, std::streamsize count)
+    {
+        if (static_cast<size_t>(count) < buffer_size)
+        {
+            return std::streambuf::xsputn(s, count);
+        }
+
+        // large writes go directly from the source to the blob
+        flush_put_area();
+        end_get_area();
+        size_t num_bytes = (position < blob_size) ? std::min(static_cast<size_t>(count), blob_size - position) : 0;
+        if (num_bytes > 0)
+        {
+            blob.write(s, num_bytes, position);
+            position += num_bytes;
+        }
+        return static_cast<std::streamsize>(num_bytes);
+    }
+
+    BlobStreamBuf::pos_type BlobStreamBuf::seekoff(
+        off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode
+    )
+    {
+        // input and output share a single position, whichever is asked for
+        flush_put_area();
+
+        off_type base = 0;
+        if (direction == std::ios_base::cur)
+        {
+            base = static_cast<off_type>(this->offset());
+        }
+        else if (direction == std::ios_base::end)
+        {
+            base = static_cast<off_type>(blob_size);
+        }
+        off_type target = base + offset;
+        if (target < 0 || target > static_cast<off_type>(blob_size))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        auto target_offset = static_cast<size_t>(target);
+        if (eback() && target_offset >= position && target_offset <= position + (egptr() - eback()))
+        {
+            // seeking within the get area keeps the buffered input
+            setg(eback(), eback() + (target_offset - position), egptr());
+        }
+        else
+        {
+            setg(nullptr, nullptr, nullptr);
+            position = target_offset;
+        }
+        return pos_type(target);
+    }
+
+    BlobStreamBuf::pos_type BlobStreamBuf::seekpos(pos_type target, std::ios_base::openmode which)
+    {
+        return seekoff(off_type(target), std::ios_base::beg, which);
+    }
+
+    size_t BlobStreamBuf::offset() const noexcept
+    {
+        if (pbase())
+        {
+            return position + (pptr() - pbase());
+        }
+        if (eback())
+        {
+            return position + (gptr() - eback());
+        }
+        return position;
+    }
+
+    void BlobStreamBuf::flush_put_area()
+    {
+        if (pbase())
+        {
+            auto num_bytes = static_cast<size_t>(pptr() - pbase());
+            if (num_bytes > 0)
+            {
+                blob.write(pbase(), num_bytes, position);
+            }
+            position += num_bytes;
+            setp(nullptr, nullptr);
+        }
+    }
+
+    void BlobStreamBuf::end_get_area() noexcept
+    {
+        if (eback())
+        {
+            position = offset();
+            setg(nullptr, nullptr, nullptr);
+        }
+    }
+
+    size_t copy_to(Blob& blob, int fd, size_t chunk_size)
+    {
+        assert(chunk_size > 0);
+
+        std::unique_ptr<char[]> chunk(new char[chunk_size]);
+        size_t blob_size = blob.size();
+        size_t num_copied = 0;
+        while (num_copied < blob_size)
+        {
+            size_t num_bytes = std::min(chunk_size, blob_size - num_copied);
+            blob.read(chunk.get(), num_bytes, num_copied);
+            write_all(fd, chunk.get(), num_bytes);
+            num_copied += num_bytes;
+        }
+        return num_copied;
+    }
+
+    size_t copy_from(Blob& blob, int fd, size_t chunk_size)
+    {
+        assert(chunk_size > 0);
+
+        std::unique_ptr<char[]> chunk(new char[chunk_size]);
+        size_t blob_size = blob.size();
+        size_t num_copied = 0;
+        while (num_copied < blob_size)
+        {
+            long num_read = read_fd(fd, chunk.get(), std::min(chunk_size, blob_size - num_copied));
+            if (num_read < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "could not read from file descriptor");
+            }
+            if (num_read == 0)
+            {
+                break;
+            }
+            blob.write(chunk.get(), static_cast<size_t>(num_read), num_copied);
+            num_copied += static_cast<size_t>(num_read);
+        }
+        return num_copied;
+    }
+}
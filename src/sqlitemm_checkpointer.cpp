@@ -0,0 +1,166 @@
+/************************************************************************************************************
+ * SQLitemm checkpointer source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_checkpointer.hpp"
+#include <cassert>
+#include <utility>
+#include "sqlite3.h"
+
+namespace sqlitemm
+{
+    Checkpointer::Checkpointer(const std::string& filename, CheckpointerOptions options) :
+        conn(filename, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX),
+        options(std::move(options)),
+        state(std::make_shared<WakeState>())
+    {
+        assert(this->options.passive_threshold_frames > 0);
+        assert(this->options.restart_threshold_frames <= this->options.truncate_threshold_frames);
+        conn.set_busy_timeout(static_cast<int>(this->options.busy_timeout.count()));
+        state->passive_threshold_frames = this->options.passive_threshold_frames;
+        thread = std::thread(&Checkpointer::run, this);
+    }
+
+    Checkpointer::~Checkpointer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->stopping = true;
+        }
+        state->wake.notify_one();
+        thread.join();
+    }
+
+    void Checkpointer::attach(Connection& writer)
+    {
+        // the hook holds the state rather than the checkpointer, since the writer may outlive the checkpointer
+        writer.set_wal_hook([state = state](const char*, int wal_frames) {
+            if (wal_frames < state->passive_threshold_frames)
+            {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->stopping || state->woken)
+                {
+                    return;
+                }
+                state->woken = true;
+            }
+            state->wake.notify_one();
+        });
+    }
+
+    void Checkpointer::wake() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->woken = true;
+        }
+        state->wake.notify_one();
+    }
+
+    CheckpointerStats Checkpointer::stats() const
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        return checkpointer_stats;
+    }
+
+    void Checkpointer::run() noexcept
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->wake.wait_for(lock, options.interval, [this] { return state->woken || state->stopping; });
+                if (state->stopping)
+                {
+                    return;
+                }
+                state->woken = false;
+            }
+
+            try
+            {
+                run_checkpoints();
+            }
+            catch (...)
+            {
+                // e.g., the database is not in WAL mode yet, so try again on the next round
+            }
+        }
+    }
+
+    void Checkpointer::run_checkpoints()
+    {
+        // a passive checkpoint never waits, and reports the size of the WAL
+        auto result = conn.checkpoint(CheckpointMode::Passive);
+        if (result.wal_frames < 0)
+        {
+            // the connection only opens the WAL once it has read the database
+            conn.execute("PRAGMA schema_version;");
+            result = conn.checkpoint(CheckpointMode::Passive);
+        }
+        if (result.wal_frames <= 0)
+        {
+            return;
+        }
+        record(CheckpointMode::Passive, result);
+
+        if (result.busy || result.wal_frames < options.restart_threshold_frames)
+        {
+            return;
+        }
+        auto mode = (result.wal_frames >= options.truncate_threshold_frames) ? CheckpointMode::Truncate
+                                                                             : CheckpointMode::Restart;
+        record(mode, conn.checkpoint(mode));
+    }
+
+    void Checkpointer::record(CheckpointMode mode, const CheckpointResult& result)
+    {
+        CheckpointReport report{mode, result};
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            // frames that a previous checkpoint of the same WAL reported are not counted again
+            int previously_checkpointed = 0;
+            if (result.wal_frames >= checkpointer_stats.wal_frames)
+            {
+                previously_checkpointed = last_checkpointed_frames;
+            }
+            int newly_checkpointed = result.checkpointed_frames - previously_checkpointed;
+            if (mode == CheckpointMode::Truncate && !result.busy && result.wal_frames == 0)
+            {
+                // a completed truncate checkpoint reports the emptied WAL
+                newly_checkpointed = checkpointer_stats.wal_frames - last_checkpointed_frames;
+            }
+
+            ++checkpointer_stats.checkpoints;
+            if (result.busy)
+            {
+                ++checkpointer_stats.busy_checkpoints;
+            }
+            if (newly_checkpointed > 0)
+            {
+                checkpointer_stats.checkpointed_frames += static_cast<unsigned long long>(newly_checkpointed);
+            }
+            checkpointer_stats.wal_frames = result.wal_frames;
+            last_checkpointed_frames = result.checkpointed_frames;
+        }
+
+        if (options.report_callback)
+        {
+            options.report_callback(report);
+        }
+    }
+}
@@ -0,0 +1,199 @@
+/************************************************************************************************************
+ * SQLitemm connection pool source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_pool.hpp"
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "sqlite3.h"
+
+namespace sqlitemm
+{
+    namespace
+    {
+        constexpr std::uint64_t free_index_mask = 0xffffffffu;
+        constexpr std::uint64_t free_tag_increment = std::uint64_t(1) << 32;
+
+        void set_up_connection(Connection& connection, const ConnectionPool::SetupFunction& setup, int busy_timeout_ms)
+        {
+            connection.set_busy_timeout(busy_timeout_ms);
+            if (setup)
+            {
+                setup(connection);
+            }
+        }
+    }
+
+    void ConnectionPool::Lease::release() noexcept
+    {
+        if (pool)
+        {
+            pool->release(slot);
+            pool = nullptr;
+        }
+    }
+
+    Connection& ConnectionPool::Lease::get() const noexcept
+    {
+        assert(pool && "lease must hold a connection");
+        return (slot == writer_slot) ? pool->writer : pool->readers[slot].connection;
+    }
+
+    ConnectionPool::ConnectionPool(
+        const std::string& filename,
+        size_t reader_count,
+        SetupFunction setup,
+        int busy_timeout_ms
+    ) : readers(new ReaderSlot[reader_count]), num_readers(reader_count)
+    {
+        if (reader_count == 0)
+        {
+            // acquire_reader() would otherwise wait forever for a reader
+            throw std::invalid_argument("connection pool must have at least one reader");
+        }
+        assert(reader_count < writer_slot && "too many readers for a connection pool");
+
+        // each connection is only ever used by the thread that leases it, so SQLite's mutexes are not needed
+        writer.open(filename, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX);
+        writer.set_busy_timeout(busy_timeout_ms);
+        {
+            auto statement = writer.prepare("PRAGMA journal_mode=WAL;");
+            auto result = statement.execute_query();
+            std::string journal_mode;
+            if (result.step())
+            {
+                journal_mode = static_cast<std::string>(result[0]);
+            }
+            if (journal_mode != "wal")
+            {
+                throw Error("database for connection pool could not be switched to WAL journal mode", SQLITE_ERROR);
+            }
+        }
+        if (setup)
+        {
+            setup(writer);
+        }
+
+        for (size_t index = 0; index < num_readers; ++index)
+        {
+            readers[index].connection.open(filename, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX);
+            set_up_connection(readers[index].connection, setup, busy_timeout_ms);
+        }
+
+        // link the slots in index order so that the first reader is leased first
+        for (size_t index = num_readers; index > 0; --index)
+        {
+            push_reader(static_cast<std::uint32_t>(index - 1));
+        }
+    }
+
+    ConnectionPool::~ConnectionPool()
+    {
+        // close the readers first so that the writer, being closed last, can checkpoint the WAL file
+        readers.reset();
+    }
+
+    ConnectionPool::Lease ConnectionPool::acquire_reader()
+    {
+        std::uint32_t slot;
+        if (try_pop_reader(slot))
+        {
+            return Lease(this, slot);
+        }
+
+        // slow path: wait for a reader to be returned
+        ++num_waiting_readers;
+        std::unique_lock<std::mutex> lock(reader_mutex);
+        reader_returned.wait(lock, [this, &slot] { return try_pop_reader(slot); });
+        --num_waiting_readers;
+        return Lease(this, slot);
+    }
+
+    ConnectionPool::Lease ConnectionPool::try_acquire_reader() noexcept
+    {
+        std::uint32_t slot;
+        return try_pop_reader(slot) ? Lease(this, slot) : Lease();
+    }
+
+    ConnectionPool::Lease ConnectionPool::acquire_writer()
+    {
+        std::unique_lock<std::mutex> lock(writer_mutex);
+        writer_returned.wait(lock, [this] { return !writer_leased; });
+        writer_leased = true;
+        return Lease(this, writer_slot);
+    }
+
+    ConnectionPool::Lease ConnectionPool::try_acquire_writer() noexcept
+    {
+        std::unique_lock<std::mutex> lock(writer_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || writer_leased)
+        {
+            return Lease();
+        }
+        writer_leased = true;
+        return Lease(this, writer_slot);
+    }
+
+    bool ConnectionPool::try_pop_reader(std::uint32_t& slot) noexcept
+    {
+        // sequentially consistent so that a waiting reader cannot miss a reader pushed by release()
+        auto head = free_head.load();
+        while ((head & free_index_mask) != 0)
+        {
+            auto index = static_cast<std::uint32_t>((head & free_index_mask) - 1);
+            // the slot may be popped concurrently, but slots are never freed and the tag detects reuse
+            auto next = readers[index].next.load(std::memory_order_relaxed);
+            auto new_head = ((head & ~free_index_mask) + free_tag_increment) | next;
+            if (free_head.compare_exchange_weak(head, new_head))
+            {
+                slot = index;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ConnectionPool::push_reader(std::uint32_t slot) noexcept
+    {
+        auto head = free_head.load(std::memory_order_relaxed);
+        std::uint64_t new_head;
+        do
+        {
+            readers[slot].next.store(static_cast<std::uint32_t>(head & free_index_mask), std::memory_order_relaxed);
+            new_head = ((head & ~free_index_mask) + free_tag_increment) | (slot + 1);
+        }
+        while (!free_head.compare_exchange_weak(head, new_head));
+    }
+
+    void ConnectionPool::release(std::uint32_t slot) noexcept
+    {
+        if (slot == writer_slot)
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex);
+            writer_leased = false;
+            writer_returned.notify_one();
+            return;
+        }
+
+        push_reader(slot);
+        if (num_waiting_readers.load() > 0)
+        {
+            // taking the lock ensures that a waiter that just failed to pop is already waiting
+            std::lock_guard<std::mutex> lock(reader_mutex);
+            reader_returned.notify_one();
+        }
+    }
+}
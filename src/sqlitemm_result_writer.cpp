@@ -0,0 +1,485 @@
+/************************************************************************************************************
+ * SQLitemm result writer source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_result_writer.hpp"
+#include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <utility>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "sqlite3.h"
+
+namespace sqlitemm
+{
+    namespace
+    {
+        using OutputBuffer = std::vector<unsigned char>;
+
+        void write_chunk_to_fd(int fd, const unsigned char* data, size_t size)
+        {
+            while (size > 0)
+            {
+#ifdef _WIN32
+                long num_written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+                long num_written = static_cast<long>(::write(fd, data, size));
+#endif
+                if (num_written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "could not write to file descriptor");
+                }
+                data += num_written;
+                size -= static_cast<size_t>(num_written);
+            }
+        }
+
+        void append(OutputBuffer& buffer, const void* data, size_t size)
+        {
+            auto bytes = static_cast<const unsigned char*>(data);
+            buffer.insert(buffer.end(), bytes, bytes + size);
+        }
+
+        void append(OutputBuffer& buffer, char c)
+        {
+            buffer.push_back(static_cast<unsigned char>(c));
+        }
+
+        void append_integer(OutputBuffer& buffer, sqlite3_int64 value)
+        {
+            char digits[24];
+            auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+            append(buffer, digits, static_cast<size_t>(end - digits));
+        }
+
+        void append_real(OutputBuffer& buffer, double value)
+        {
+            // the shortest representation that reads back as the same value
+            char digits[32];
+            auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+            append(buffer, digits, static_cast<size_t>(end - digits));
+        }
+
+        void append_little_endian(OutputBuffer& buffer, std::uint64_t value, size_t num_bytes)
+        {
+            for (size_t i = 0; i < num_bytes; ++i)
+            {
+                buffer.push_back(static_cast<unsigned char>(value >> (8 * i)));
+            }
+        }
+
+        void append_hex(OutputBuffer& buffer, const unsigned char* data, size_t size)
+        {
+            static const char hex_digits[] = "0123456789ABCDEF";
+            for (size_t i = 0; i < size; ++i)
+            {
+                buffer.push_back(static_cast<unsigned char>(hex_digits[data[i] >> 4]));
+                buffer.push_back(static_cast<unsigned char>(hex_digits[data[i] & 0xf]));
+            }
+        }
+
+        void append_base64(OutputBuffer& buffer, const unsigned char* data, size_t size)
+        {
+            static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            size_t i = 0;
+            for (; i + 3 <= size; i += 3)
+            {
+                std::uint32_t group = (std::uint32_t{data[i]} << 16) | (std::uint32_t{data[i + 1]} << 8) | data[i + 2];
+                append(buffer, alphabet[group >> 18]);
+                append(buffer, alphabet[(group >> 12) & 0x3f]);
+                append(buffer, alphabet[(group >> 6) & 0x3f]);
+                append(buffer, alphabet[group & 0x3f]);
+            }
+            if (i < size)
+            {
+                std::uint32_t group = std::uint32_t{data[i]} << 16;
+                if (i + 1 < size)
+                {
+                    group |= std::uint32_t{data[i + 1]} << 8;
+                }
+                append(buffer, alphabet[group >> 18]);
+                append(buffer, alphabet[(group >> 12) & 0x3f]);
+                append(buffer, (i + 1 < size) ? alphabet[(group >> 6) & 0x3f] : '=');
+                append(buffer, '=');
+            }
+        }
+
+        void append_csv_text(OutputBuffer& buffer, const char* text, size_t size)
+        {
+            bool needs_quotes = false;
+            for (size_t i = 0; i < size && !needs_quotes; ++i)
+            {
+                needs_quotes = text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r';
+            }
+            if (!needs_quotes)
+            {
+                append(buffer, text, size);
+                return;
+            }
+
+            append(buffer, '"');
+            size_t run_start = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (text[i] == '"')
+                {
+                    // write the run up to and including the quote, then double it
+                    append(buffer, text + run_start, i + 1 - run_start);
+                    append(buffer, '"');
+                    run_start = i + 1;
+                }
+            }
+            append(buffer, text + run_start, size - run_start);
+            append(buffer, '"');
+        }
+
+        void append_json_string(OutputBuffer& buffer, const char* text, size_t size)
+        {
+            static const char hex_digits[] = "0123456789abcdef";
+            append(buffer, '"');
+            size_t run_start = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                auto c = static_cast<unsigned char>(text[i]);
+                if (c >= 0x20 && c != '"' && c != '\\')
+                {
+                    continue;
+                }
+                append(buffer, text + run_start, i - run_start);
+                run_start = i + 1;
+                switch (c)
+                {
+                case '"':
+                    append(buffer, "\\\"", 2);
+                    break;
+                case '\\':
+                    append(buffer, "\\\\", 2);
+                    break;
+                case '\n':
+                    append(buffer, "\\n", 2);
+                    break;
+                case '\r':
+                    append(buffer, "\\r", 2);
+                    break;
+                case '\t':
+                    append(buffer, "\\t", 2);
+                    break;
+                default:
+                    append(buffer, "\\u00", 4);
+                    append(buffer, hex_digits[c >> 4]);
+                    append(buffer, hex_digits[c & 0xf]);
+                    break;
+                }
+            }
+            append(buffer, text + run_start, size - run_start);
+            append(buffer, '"');
+        }
+    }
+
+    ResultWriter::ResultWriter(Sink sink, ResultWriterOptions options) :
+        sink(std::move(sink)), options(std::move(options))
+    {
+        assert(this->sink);
+        if (this->options.chunk_size == 0)
+        {
+            this->options.chunk_size = 1;
+        }
+        // room for the row that completes a chunk, so that the buffer is rarely reallocated
+        buffer.reserve(this->options.chunk_size + this->options.chunk_size / 4);
+    }
+
+    ResultWriter::ResultWriter(int fd, ResultWriterOptions options) :
+        ResultWriter([fd](const unsigned char* data, size_t size) { write_chunk_to_fd(fd, data, size); },
+                     std::move(options)) {}
+
+    ResultWriter::~ResultWriter()
+    {
+        try
+        {
+            finish();
+        }
+        catch (...)
+        {
+            // ignore, as documented
+        }
+    }
+
+    size_t ResultWriter::write(Result& result)
+    {
+        assert(result.stmt);
+        if (!header_written)
+        {
+            write_header(result);
+            header_written = true;
+        }
+        if (options.format == ResultFormat::NdJson)
+        {
+            // the keys are formatted once per result set rather than once per row
+            int num_columns = sqlite3_column_count(result.stmt);
+            json_keys.resize(static_cast<size_t>(num_columns));
+            OutputBuffer key;
+            for (int i = 0; i < num_columns; ++i)
+            {
+                key.clear();
+                if (i > 0)
+                {
+                    append(key, ',');
+                }
+                const char* name = sqlite3_column_name(result.stmt, i);
+                append_json_string(key, name, std::strlen(name));
+                append(key, ':');
+                json_keys[static_cast<size_t>(i)].assign(key.begin(), key.end());
+            }
+        }
+
+        size_t num_rows = 0;
+        while (result.step())
+        {
+            write_row(result);
+            ++num_rows;
+            if (buffer.size() >= options.chunk_size)
+            {
+                complete_chunk();
+            }
+        }
+        return num_rows;
+    }
+
+    void ResultWriter::finish()
+    {
+        complete_chunk();
+        while (!compression_tasks.empty())
+        {
+            drain_compression_task();
+        }
+    }
+
+    void ResultWriter::write_header(Result& result)
+    {
+        int num_columns = sqlite3_column_count(result.stmt);
+        if (options.format == ResultFormat::Csv && options.header)
+        {
+            for (int i = 0; i < num_columns; ++i)
+            {
+                if (i > 0)
+                {
+                    append(buffer, ',');
+                }
+                const char* name = sqlite3_column_name(result.stmt, i);
+                append_csv_text(buffer, name, std::strlen(name));
+            }
+            append(buffer, "\r\n", 2);
+        }
+        else if (options.format == ResultFormat::Binary)
+        {
+            append_little_endian(buffer, static_cast<std::uint64_t>(num_columns), 4);
+            for (int i = 0; i < num_columns; ++i)
+            {
+                const char* name = sqlite3_column_name(result.stmt, i);
+                size_t size = std::strlen(name);
+                append_little_endian(buffer, size, 4);
+                append(buffer, name, size);
+            }
+        }
+    }
+
+    void ResultWriter::write_row(Result& result)
+    {
+        sqlite3_stmt* stmt = result.stmt;
+        int num_columns = sqlite3_column_count(stmt);
+        if (options.format == ResultFormat::NdJson)
+        {
+            append(buffer, '{');
+        }
+
+        for (int i = 0; i < num_columns; ++i)
+        {
+            int type = sqlite3_column_type(stmt, i);
+            switch (options.format)
+            {
+            case ResultFormat::Csv:
+                if (i > 0)
+                {
+                    append(buffer, ',');
+                }
+                break;
+            case ResultFormat::NdJson:
+                append(buffer, json_keys[static_cast<size_t>(i)].data(), json_keys[static_cast<size_t>(i)].size());
+                break;
+            case ResultFormat::Binary:
+                append(buffer, static_cast<char>(type));
+                break;
+            }
+
+            switch (type)
+            {
+            case SQLITE_INTEGER:
+            {
+                sqlite3_int64 value = sqlite3_column_int64(stmt, i);
+                if (options.format == ResultFormat::Binary)
+                {
+                    append_little_endian(buffer, static_cast<std::uint64_t>(value), 8);
+                }
+                else
+                {
+                    append_integer(buffer, value);
+                }
+                break;
+            }
+            case SQLITE_FLOAT:
+            {
+                double value = sqlite3_column_double(stmt, i);
+                if (options.format == ResultFormat::Binary)
+                {
+                    std::uint64_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    append_little_endian(buffer, bits, 8);
+                }
+                else if (options.format == ResultFormat::NdJson && !std::isfinite(value))
+                {
+                    append(buffer, "null", 4);
+                }
+                else
+                {
+                    append_real(buffer, value);
+                }
+                break;
+            }
+            case SQLITE_TEXT:
+            {
+                auto text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
+                auto size = static_cast<size_t>(sqlite3_column_bytes(stmt, i));
+                if (options.format == ResultFormat::Csv)
+                {
+                    append_csv_text(buffer, text, size);
+                }
+                else if (options.format == ResultFormat::NdJson)
+                {
+                    append_json_string(buffer, text, size);
+                }
+                else
+                {
+                    append_little_endian(buffer, size, 4);
+                    append(buffer, text, size);
+                }
+                break;
+            }
+            case SQLITE_BLOB:
+            {
+                auto content = static_cast<const unsigned char*>(sqlite3_column_blob(stmt, i));
+                auto size = static_cast<size_t>(sqlite3_column_bytes(stmt, i));
+                if (options.format == ResultFormat::Csv)
+                {
+                    append_hex(buffer, content, size);
+                }
+                else if (options.format == ResultFormat::NdJson)
+                {
+                    append(buffer, '"');
+                    append_base64(buffer, content, size);
+                    append(buffer, '"');
+                }
+                else
+                {
+                    append_little_endian(buffer, size, 4);
+                    append(buffer, content, size);
+                }
+                break;
+            }
+            default:
+                if (options.format == ResultFormat::NdJson)
+                {
+                    append(buffer, "null", 4);
+                }
+                break;
+            }
+        }
+
+        if (options.format == ResultFormat::Csv)
+        {
+            append(buffer, "\r\n", 2);
+        }
+        else if (options.format == ResultFormat::NdJson)
+        {
+            append(buffer, "}\n", 2);
+        }
+    }
+
+    void ResultWriter::complete_chunk()
+    {
+        if (buffer.empty())
+        {
+            return;
+        }
+        if (!options.compressor)
+        {
+            sink(buffer.data(), buffer.size());
+            buffer.clear();
+            return;
+        }
+        if (options.compression_threads == 0)
+        {
+            auto compressed = options.compressor(buffer.data(), buffer.size());
+            buffer.clear();
+            sink(compressed.data(), compressed.size());
+            return;
+        }
+
+        if (compression_tasks.size() >= options.compression_threads)
+        {
+            drain_compression_task();
+        }
+        CompressionTask task;
+        task.chunk = std::move(buffer);
+        const unsigned char* data = task.chunk.data();
+        size_t size = task.chunk.size();
+        task.compressed = std::async(std::launch::async, [&compressor = options.compressor, data, size] {
+            return compressor(data, size);
+        });
+        compression_tasks.push_back(std::move(task));
+
+        // carry on writing into the buffer of a chunk that has been handed over, if any
+        if (spare_buffers.empty())
+        {
+            buffer = OutputBuffer();
+            buffer.reserve(options.chunk_size + options.chunk_size / 4);
+        }
+        else
+        {
+            buffer = std::move(spare_buffers.back());
+            spare_buffers.pop_back();
+        }
+    }
+
+    void ResultWriter::drain_compression_task()
+    {
+        auto task = std::move(compression_tasks.front());
+        compression_tasks.pop_front();
+        auto compressed = task.compressed.get();
+        sink(compressed.data(), compressed.size());
+        task.chunk.clear();
+        spare_buffers.push_back(std::move(task.chunk));
+    }
+}
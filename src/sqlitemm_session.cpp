@@ -0,0 +1,339 @@
+/************************************************************************************************************
+ * SQLitemm session source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_session.hpp"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <exception>
+#include <memory>
+#include <string>
+#include "sqlite3.h"
+
+namespace sqlitemm
+{
+    namespace
+    {
+        void throw_session_error(sqlite3* db, int result_code)
+        {
+            // the session functions do not all set the error message of the database connection
+            const char* message = (db && sqlite3_errcode(db) == result_code) ? sqlite3_errmsg(db)
+                                                                             : sqlite3_errstr(result_code);
+            auto what_arg = std::string(message) + " (" + std::to_string(result_code) + ")";
+            switch (result_code & 0xff)
+            {
+            case SQLITE_BUSY:
+                throw BusyError(what_arg, result_code);
+            case SQLITE_CONSTRAINT:
+                throw ConstraintError(what_arg, result_code);
+            default:
+                throw Error(what_arg, result_code);
+            }
+        }
+
+        void check_session_ok(sqlite3* db, int result_code)
+        {
+            if (result_code != SQLITE_OK)
+            {
+                throw_session_error(db, result_code);
+            }
+        }
+
+        // state of a call to apply the changeset, passed through SQLite to the callbacks
+        struct ApplyContext
+        {
+            const Session::ConflictHandler& on_conflict;
+            const Session::TableFilter& filter;
+            const Session::ChangesetInput* input;
+            std::exception_ptr exception;
+        };
+
+        int filter_table(void* context, const char* table) noexcept
+        {
+            auto& apply_context = *static_cast<ApplyContext*>(context);
+            if (!apply_context.filter || apply_context.exception)
+            {
+                return apply_context.exception ? 0 : 1;
+            }
+            try
+            {
+                return apply_context.filter(table) ? 1 : 0;
+            }
+            catch (...)
+            {
+                apply_context.exception = std::current_exception();
+                return 0;
+            }
+        }
+
+        int read_input(void* context, void* buffer, int* num_bytes) noexcept
+        {
+            auto& apply_context = *static_cast<ApplyContext*>(context);
+            try
+            {
+                auto capacity = static_cast<std::size_t>(*num_bytes);
+                auto num_read = (*apply_context.input)(static_cast<unsigned char*>(buffer), capacity);
+                assert(num_read <= capacity && "changeset input must not overfill the buffer");
+                *num_bytes = static_cast<int>(std::min(num_read, capacity));
+                return SQLITE_OK;
+            }
+            catch (...)
+            {
+                apply_context.exception = std::current_exception();
+                return SQLITE_IOERR;
+            }
+        }
+
+        // state of a call to stream the changeset out, passed through SQLite to the callback
+        struct OutputContext
+        {
+            const Session::ChangesetOutput& output;
+            std::exception_ptr exception;
+        };
+
+        int write_output(void* context, const void* data, int num_bytes) noexcept
+        {
+            auto& output_context = *static_cast<OutputContext*>(context);
+            try
+            {
+                output_context.output(static_cast<const unsigned char*>(data), static_cast<std::size_t>(num_bytes));
+                return SQLITE_OK;
+            }
+            catch (...)
+            {
+                output_context.exception = std::current_exception();
+                return SQLITE_IOERR;
+            }
+        }
+
+        std::vector<unsigned char> take_buffer(int num_bytes, void* buffer)
+        {
+            // copy the buffer allocated by SQLite, freeing it even if the copy throws
+            std::unique_ptr<void, decltype(&sqlite3_free)> owner(buffer, &sqlite3_free);
+            auto bytes = static_cast<const unsigned char*>(buffer);
+            return std::vector<unsigned char>(bytes, bytes + num_bytes);
+        }
+
+        void check_stream_ok(sqlite3* db, int result_code, const std::exception_ptr& exception)
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+            check_session_ok(db, result_code);
+        }
+    }
+
+    ChangesetConflict::ChangesetConflict(sqlite3_changeset_iter* iter, ConflictType conflict_type) :
+        iter(iter), conflict_type(conflict_type)
+    {
+        if (conflict_type == ConflictType::ForeignKey)
+        {
+            return;
+        }
+        const char* table = nullptr;
+        int operation = 0;
+        if (sqlite3changeset_op(iter, &table, &num_columns, &operation, nullptr) == SQLITE_OK)
+        {
+            table_name = table ? std::string_view(table) : std::string_view();
+            change_operation = (operation == SQLITE_INSERT) ? ChangeOperation::Insert
+                             : (operation == SQLITE_UPDATE) ? ChangeOperation::Update
+                                                            : ChangeOperation::Delete;
+        }
+    }
+
+    int ChangesetConflict::foreign_key_conflicts() const
+    {
+        int num_conflicts = 0;
+        check_session_ok(nullptr, sqlite3changeset_fk_conflicts(iter, &num_conflicts));
+        return num_conflicts;
+    }
+
+    sqlite3_value* ChangesetConflict::raw_value(ValueGetter getter, int column) const
+    {
+        sqlite3_value* value = nullptr;
+        check_session_ok(nullptr, getter(iter, column, &value));
+        return value;
+    }
+
+    Session::Session(Connection& conn, const std::string& schema_name) : db(conn.db)
+    {
+        assert(db && "database connection must be open to create a session");
+        int result_code = sqlite3session_create(db, schema_name.c_str(), &session);
+        if (result_code != SQLITE_OK)
+        {
+            session = nullptr;
+            throw_session_error(db, result_code);
+        }
+    }
+
+    void Session::attach(const std::string& table)
+    {
+        check_session_ok(db, sqlite3session_attach(session, table.c_str()));
+    }
+
+    void Session::attach_all()
+    {
+        check_session_ok(db, sqlite3session_attach(session, nullptr));
+    }
+
+    void Session::enable(bool enabled) noexcept
+    {
+        sqlite3session_enable(session, enabled ? 1 : 0);
+    }
+
+    bool Session::enabled() const noexcept
+    {
+        return sqlite3session_enable(session, -1) != 0;
+    }
+
+    bool Session::empty() const noexcept
+    {
+        return sqlite3session_isempty(session) != 0;
+    }
+
+    std::vector<unsigned char> Session::changeset()
+    {
+        int num_bytes = 0;
+        void* buffer = nullptr;
+        int result_code = sqlite3session_changeset(session, &num_bytes, &buffer);
+        if (result_code != SQLITE_OK)
+        {
+            sqlite3_free(buffer);
+            throw_session_error(db, result_code);
+        }
+        return take_buffer(num_bytes, buffer);
+    }
+
+    void Session::changeset(const ChangesetOutput& output)
+    {
+        OutputContext context{output, nullptr};
+        int result_code = sqlite3session_changeset_strm(session, &write_output, &context);
+        check_stream_ok(db, result_code, context.exception);
+    }
+
+    std::vector<unsigned char> Session::patchset()
+    {
+        int num_bytes = 0;
+        void* buffer = nullptr;
+        int result_code = sqlite3session_patchset(session, &num_bytes, &buffer);
+        if (result_code != SQLITE_OK)
+        {
+            sqlite3_free(buffer);
+            throw_session_error(db, result_code);
+        }
+        return take_buffer(num_bytes, buffer);
+    }
+
+    void Session::patchset(const ChangesetOutput& output)
+    {
+        OutputContext context{output, nullptr};
+        int result_code = sqlite3session_patchset_strm(session, &write_output, &context);
+        check_stream_ok(db, result_code, context.exception);
+    }
+
+    void Session::apply(Connection& conn, BlobView changeset, const ConflictHandler& on_conflict,
+                        const TableFilter& filter)
+    {
+        assert(conn.db && "database connection must be open to apply a changeset");
+        assert(changeset.size() <= static_cast<std::size_t>(INT_MAX) && "changeset is too large to apply at once");
+        ApplyContext context{on_conflict, filter, nullptr, nullptr};
+        // the filter cannot abort, so the changes are rolled back through an enclosing savepoint instead
+        auto savepoint = conn.begin_savepoint();
+        // SQLite does not modify the changeset that it applies
+        int result_code = sqlite3changeset_apply(
+            conn.db, static_cast<int>(changeset.size()), const_cast<unsigned char*>(changeset.data()),
+            &filter_table, &handle_conflict, &context
+        );
+        check_stream_ok(conn.db, result_code, context.exception);
+        savepoint.release();
+    }
+
+    void Session::apply_stream(Connection& conn, const ChangesetInput& input, const ConflictHandler& on_conflict,
+                               const TableFilter& filter)
+    {
+        assert(conn.db && "database connection must be open to apply a changeset");
+        ApplyContext context{on_conflict, filter, &input, nullptr};
+        auto savepoint = conn.begin_savepoint();
+        int result_code = sqlite3changeset_apply_strm(
+            conn.db, &read_input, &context, &filter_table, &handle_conflict, &context
+        );
+        check_stream_ok(conn.db, result_code, context.exception);
+        savepoint.release();
+    }
+
+    int Session::handle_conflict(void* context, int conflict, sqlite3_changeset_iter* iter) noexcept
+    {
+        auto& apply_context = *static_cast<ApplyContext*>(context);
+        if (!apply_context.on_conflict || apply_context.exception)
+        {
+            return SQLITE_CHANGESET_ABORT;
+        }
+
+        ConflictType conflict_type = ConflictType::Data;
+        switch (conflict)
+        {
+        case SQLITE_CHANGESET_NOTFOUND:
+            conflict_type = ConflictType::NotFound;
+            break;
+        case SQLITE_CHANGESET_CONFLICT:
+            conflict_type = ConflictType::Conflict;
+            break;
+        case SQLITE_CHANGESET_CONSTRAINT:
+            conflict_type = ConflictType::Constraint;
+            break;
+        case SQLITE_CHANGESET_FOREIGN_KEY:
+            conflict_type = ConflictType::ForeignKey;
+            break;
+        default:
+            break;
+        }
+
+        try
+        {
+            switch (apply_context.on_conflict(ChangesetConflict(iter, conflict_type)))
+            {
+            case ConflictAction::Omit:
+                return SQLITE_CHANGESET_OMIT;
+            case ConflictAction::Replace:
+                if (conflict_type != ConflictType::Data && conflict_type != ConflictType::Conflict)
+                {
+                    // SQLite would fail with SQLITE_MISUSE and no indication of why
+                    throw Error(
+                        "ConflictAction::Replace is only valid for Data and Conflict conflicts", SQLITE_MISUSE
+                    );
+                }
+                return SQLITE_CHANGESET_REPLACE;
+            default:
+                return SQLITE_CHANGESET_ABORT;
+            }
+        }
+        catch (...)
+        {
+            apply_context.exception = std::current_exception();
+            return SQLITE_CHANGESET_ABORT;
+        }
+    }
+
+    void Session::close() noexcept
+    {
+        if (session)
+        {
+            sqlite3session_delete(session);
+            session = nullptr;
+        }
+        db = nullptr;
+    }
+}
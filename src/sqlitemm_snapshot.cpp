@@ -0,0 +1,130 @@
+/************************************************************************************************************
+ * SQLitemm snapshot source file
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include "sqlitemm_snapshot.hpp"
+#include <cerrno>
+#include <system_error>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sqlitemm
+{
+#ifdef _WIN32
+    SharedSnapshot::SharedSnapshot(const std::string& filename)
+    {
+        HANDLE file = CreateFileA(
+            filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), filename);
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            auto error = GetLastError();
+            CloseHandle(file);
+            throw std::system_error(static_cast<int>(error), std::system_category(), filename);
+        }
+        image_size = static_cast<std::size_t>(file_size.QuadPart);
+        if (image_size == 0)
+        {
+            // an empty file cannot be mapped, but is an empty database
+            CloseHandle(file);
+            return;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        auto error = GetLastError();
+        CloseHandle(file);
+        if (!mapping)
+        {
+            throw std::system_error(static_cast<int>(error), std::system_category(), filename);
+        }
+        image = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!image)
+        {
+            error = GetLastError();
+            CloseHandle(mapping);
+            throw std::system_error(static_cast<int>(error), std::system_category(), filename);
+        }
+    }
+
+    SharedSnapshot::~SharedSnapshot()
+    {
+        if (image)
+        {
+            UnmapViewOfFile(image);
+            CloseHandle(mapping);
+        }
+    }
+#else
+    SharedSnapshot::SharedSnapshot(const std::string& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            throw std::system_error(errno, std::generic_category(), filename);
+        }
+        struct stat file_status;
+        if (::fstat(fd, &file_status) == -1)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), filename);
+        }
+        image_size = static_cast<std::size_t>(file_status.st_size);
+        if (image_size == 0)
+        {
+            // an empty file cannot be mapped, but is an empty database
+            ::close(fd);
+            return;
+        }
+
+        // the mapping remains valid after the file descriptor is closed
+        void* address = ::mmap(nullptr, image_size, PROT_READ, MAP_SHARED, fd, 0);
+        int error = errno;
+        ::close(fd);
+        if (address == MAP_FAILED)
+        {
+            throw std::system_error(error, std::generic_category(), filename);
+        }
+        // lookups touch pages of the b-trees in no particular order
+        ::madvise(address, image_size, MADV_RANDOM);
+        image = static_cast<const unsigned char*>(address);
+    }
+
+    SharedSnapshot::~SharedSnapshot()
+    {
+        if (image)
+        {
+            ::munmap(const_cast<unsigned char*>(image), image_size);
+        }
+    }
+#endif
+
+    Connection SharedSnapshot::connect() const
+    {
+        Connection conn;
+        conn.open_readonly_snapshot(image, image_size);
+        return conn;
+    }
+}
@@ -0,0 +1,151 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::AsyncConnection
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <exception>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "sqlitemm_async.hpp"
+#include "catch.hpp"
+
+SCENARIO("work can be submitted to a connection owned by a worker thread")
+{
+    GIVEN("an asynchronous connection to a database with a table")
+    {
+        sqlitemm::AsyncConnection conn(":memory:");
+        conn.execute("CREATE TABLE notes (id INTEGER PRIMARY KEY, content TEXT);").get();
+
+        WHEN("statements and a query are submitted without waiting in between")
+        {
+            auto first = conn.execute("INSERT INTO notes (id, content) VALUES (?, ?);", 1, "hello");
+            auto second = conn.execute("INSERT INTO notes (id, content) VALUES (?, ?);", 2, std::string("world"));
+            auto update = conn.execute("UPDATE notes SET content = content || '!';");
+            auto rows = conn.query<int, std::string>("SELECT id, content FROM notes WHERE id >= ? ORDER BY id;", 1);
+
+            THEN("they are run in submission order")
+            {
+                REQUIRE(first.get() == 1);
+                REQUIRE(second.get() == 1);
+                REQUIRE(update.get() == 2);
+                auto result = rows.get();
+                REQUIRE(result.size() == 2);
+                REQUIRE(result[0] == std::make_tuple(1, std::string("hello!")));
+                REQUIRE(result[1] == std::make_tuple(2, std::string("world!")));
+            }
+        }
+
+        WHEN("a submitted statement fails")
+        {
+            conn.execute("INSERT INTO notes (id, content) VALUES (1, 'a');").get();
+            auto duplicate = conn.execute("INSERT INTO notes (id, content) VALUES (1, 'b');");
+            auto count = conn.query<int>("SELECT COUNT(*) FROM notes;");
+
+            THEN("the exception is delivered through the future and later work still runs")
+            {
+                REQUIRE_THROWS_AS(duplicate.get(), sqlitemm::ConstraintError);
+                REQUIRE(std::get<0>(count.get().at(0)) == 1);
+            }
+        }
+
+        WHEN("arbitrary work is submitted with a future and with completion callbacks")
+        {
+            auto last_id = conn.submit([](sqlitemm::Connection& c) {
+                c.execute("INSERT INTO notes (content) VALUES ('callable');");
+                return c.last_insert_rowid();
+            });
+            std::promise<std::optional<long long>> value_promise;
+            conn.submit(
+                [](sqlitemm::Connection& c) { return c.last_insert_rowid() + 1; },
+                [&value_promise](std::exception_ptr error, std::optional<long long> value) {
+                    value_promise.set_value(error ? std::nullopt : value);
+                }
+            );
+            std::string label = "notes";
+            std::promise<std::optional<std::string>> reference_promise;
+            conn.submit(
+                [&label](sqlitemm::Connection&) -> const std::string& { return label; },
+                [&reference_promise](std::exception_ptr, std::optional<std::string> value) {
+                    reference_promise.set_value(std::move(value));
+                }
+            );
+            std::promise<bool> error_promise;
+            conn.submit(
+                [](sqlitemm::Connection& c) { c.execute("SELECT * FROM missing_table;"); },
+                [&error_promise](std::exception_ptr error) { error_promise.set_value(static_cast<bool>(error)); }
+            );
+
+            THEN("the result or error of each is reported")
+            {
+                REQUIRE(last_id.get() == 1);
+                REQUIRE(value_promise.get_future().get() == 2);
+                REQUIRE(reference_promise.get_future().get() == std::string("notes"));
+                REQUIRE(error_promise.get_future().get());
+            }
+        }
+    }
+}
+
+SCENARIO("work submitted concurrently to an asynchronous connection is all run")
+{
+    GIVEN("an asynchronous connection to a database with a table")
+    {
+        const int num_threads = 4;
+        const int num_inserts = 250;
+        std::vector<std::vector<std::future<int>>> futures(num_threads);
+        std::future<std::vector<std::tuple<int, int>>> totals;
+        {
+            sqlitemm::AsyncConnection conn(":memory:");
+            conn.execute("CREATE TABLE counts (thread INTEGER, value INTEGER);").get();
+
+            std::vector<std::thread> producers;
+            for (int thread = 0; thread < num_threads; ++thread)
+            {
+                producers.emplace_back([&conn, &futures, thread] {
+                    for (int value = 0; value < num_inserts; ++value)
+                    {
+                        futures[thread].push_back(
+                            conn.execute("INSERT INTO counts (thread, value) VALUES (?, ?);", thread, value)
+                        );
+                    }
+                });
+            }
+            for (auto& producer : producers)
+            {
+                producer.join();
+            }
+            totals = conn.query<int, int>("SELECT COUNT(*), COUNT(DISTINCT thread * 1000 + value) FROM counts;");
+        }
+
+        WHEN("several threads have submitted inserts and the connection has been destroyed")
+        {
+            THEN("every insert has been run exactly once")
+            {
+                for (auto& thread_futures : futures)
+                {
+                    for (auto& future : thread_futures)
+                    {
+                        REQUIRE(future.get() == 1);
+                    }
+                }
+                auto total = totals.get().at(0);
+                REQUIRE(std::get<0>(total) == num_threads * num_inserts);
+                REQUIRE(std::get<1>(total) == num_threads * num_inserts);
+            }
+        }
+    }
+}
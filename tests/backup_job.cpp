@@ -0,0 +1,141 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::BackupJob
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <vector>
+#include "sqlitemm_backup_job.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    void populate(sqlitemm::Connection& connection, int num_rows)
+    {
+        connection.execute("CREATE TABLE notes (id INTEGER PRIMARY KEY, content TEXT);");
+        auto transaction = connection.begin_transaction();
+        auto stmt = connection.prepare("INSERT INTO notes (id, content) VALUES (:id, :content);");
+        stmt[":content"] = "sample content for the notes table";
+        for (int row_count = 0; row_count < num_rows; ++row_count)
+        {
+            stmt[":id"] = row_count + 1;
+            stmt.execute();
+            stmt.reset();
+        }
+        transaction.commit();
+    }
+
+    int count_notes(sqlitemm::Connection& connection)
+    {
+        auto stmt = connection.prepare("SELECT COUNT(*) FROM notes;");
+        auto result = stmt.execute_query();
+        int count = 0;
+        REQUIRE(result.step());
+        result >> count;
+        return count;
+    }
+}
+
+SCENARIO("a database can be backed up in the background")
+{
+    GIVEN("a database with a table created and populated over many pages, and another database")
+    {
+        const int num_rows = 2000;
+        sqlitemm::Connection source(":memory:");
+        populate(source, num_rows);
+        sqlitemm::Connection destination(":memory:");
+
+        WHEN("a backup job is run to completion with a progress callback")
+        {
+            std::vector<sqlitemm::BackupProgress> reports;
+            sqlitemm::BackupJobOptions options;
+            options.min_pages_per_step = 1;
+            options.max_pages_per_step = 4;
+            options.progress_callback = [&reports](const sqlitemm::BackupProgress& progress) {
+                reports.push_back(progress);
+            };
+            sqlitemm::BackupJob job(source, "main", destination, "main", options);
+
+            THEN("the job completes after reporting progress towards copying every page")
+            {
+                REQUIRE(job.wait() == sqlitemm::BackupStatus::Completed);
+                REQUIRE(reports.size() > 1);
+                REQUIRE(reports.back().pages_remaining == 0);
+                REQUIRE(reports.back().page_count > 1);
+                for (size_t i = 1; i < reports.size(); ++i)
+                {
+                    REQUIRE(reports[i].pages_remaining < reports[i - 1].pages_remaining);
+                }
+                REQUIRE(job.progress().pages_remaining == 0);
+                REQUIRE(job.progress().page_count == reports.back().page_count);
+                REQUIRE(count_notes(destination) == num_rows);
+            }
+        }
+
+        WHEN("a backup job is cancelled while pausing between steps")
+        {
+            sqlitemm::BackupJobOptions options;
+            options.min_pages_per_step = 1;
+            options.max_pages_per_step = 1;
+            options.step_interval = std::chrono::milliseconds(60000);
+            sqlitemm::BackupJob job(source, "main", destination, "main", options);
+            auto result = job.result();
+            REQUIRE(result.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+            job.cancel();
+
+            THEN("the job stops without waiting for the pause to end")
+            {
+                REQUIRE(result.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+                REQUIRE(job.wait() == sqlitemm::BackupStatus::Cancelled);
+                REQUIRE(job.progress().pages_remaining > 0);
+            }
+        }
+    }
+}
+
+SCENARIO("a background backup backs off while the source database is locked")
+{
+    GIVEN("a database file with a table created and populated, and a connection holding an exclusive lock on it")
+    {
+        const char* const filename = "backup_job_test.db";
+        std::remove(filename);
+        {
+            sqlitemm::Connection source(filename);
+            populate(source, 100);
+            sqlitemm::Connection writer(filename);
+            auto transaction = writer.begin_transaction(sqlitemm::TransactionMode::Exclusive);
+            sqlitemm::Connection destination(":memory:");
+
+            WHEN("a backup job is started and the lock is later released")
+            {
+                sqlitemm::BackupJobOptions options;
+                options.min_backoff = std::chrono::milliseconds(1);
+                options.max_backoff = std::chrono::milliseconds(10);
+                sqlitemm::BackupJob job(source, "main", destination, "main", options);
+                auto result = job.result();
+                REQUIRE(result.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+                REQUIRE(job.progress().page_count == 0);
+                transaction.rollback();
+
+                THEN("the job completes once the source database is no longer locked")
+                {
+                    REQUIRE(job.wait() == sqlitemm::BackupStatus::Completed);
+                    REQUIRE(count_notes(destination) == 100);
+                }
+            }
+        }
+        std::remove(filename);
+    }
+}
@@ -0,0 +1,162 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::BlobStreamBuf and the blob streams
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include "sqlitemm_blob_stream.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    std::string make_content(size_t num_bytes)
+    {
+        std::string content(num_bytes, '\0');
+        for (size_t i = 0; i < num_bytes; ++i)
+        {
+            content[i] = static_cast<char>('a' + i % 26);
+        }
+        return content;
+    }
+
+    std::string read_content(sqlitemm::Connection& conn, int id)
+    {
+        auto select_statement = conn.prepare("SELECT content FROM notes WHERE id = ?");
+        select_statement << id;
+        auto result = select_statement.execute_query();
+        REQUIRE(result.step());
+        return result[0];
+    }
+}
+
+SCENARIO("blobs can be read and written through streams")
+{
+    GIVEN("a database connection with a table of zero-filled blobs")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(conn.execute("CREATE TABLE notes (id INTEGER PRIMARY KEY, content BLOB);"
+                                     "INSERT INTO notes (id, content) VALUES (1, zeroblob(1000)), (2, zeroblob(300));"));
+        const auto content = make_content(1000);
+
+        WHEN("content is written through an output stream with a small buffer")
+        {
+            {
+                auto blob = conn.open_blob("main", "notes", "content", 1, sqlitemm::Blob::READ_WRITE);
+                sqlitemm::BlobOStream out(blob, 64);
+                out << content.substr(0, 10);
+                out.write(content.data() + 10, 500);
+                for (size_t i = 510; i < content.size(); ++i)
+                {
+                    out.put(content[i]);
+                }
+                REQUIRE(out.flush());
+            }
+
+            THEN("the blob holds the content")
+            {
+                REQUIRE(read_content(conn, 1) == content);
+            }
+        }
+
+        WHEN("writing past the end of the blob")
+        {
+            auto blob = conn.open_blob("main", "notes", "content", 2, sqlitemm::Blob::READ_WRITE);
+            sqlitemm::BlobOStream out(blob, 64);
+            out.write(content.data(), 301);
+
+            THEN("the stream fails since the blob cannot grow")
+            {
+                REQUIRE_FALSE(out);
+                REQUIRE(read_content(conn, 2) == content.substr(0, 300));
+            }
+        }
+
+        WHEN("content is read through an input stream with a small buffer")
+        {
+            REQUIRE_NOTHROW(conn.execute("UPDATE notes SET content = CAST('" + content + "' AS BLOB) WHERE id = 1;"));
+            auto blob = conn.open_blob("main", "notes", "content", 1, sqlitemm::Blob::READ_ONLY);
+            sqlitemm::BlobIStream in(blob, 64);
+
+            THEN("small and large reads return the content in order")
+            {
+                std::string value(700, '\0');
+                REQUIRE(in.read(&value[0], 5));
+                REQUIRE(static_cast<char>(in.get()) == content[5]);
+                REQUIRE(in.read(&value[6], 694));
+                std::string rest(std::istreambuf_iterator<char>(in), {});
+                REQUIRE(value.substr(0, 5) + content[5] + value.substr(6) + rest == content);
+            }
+
+            THEN("the stream can seek within and beyond its buffer")
+            {
+                REQUIRE(in.seekg(500));
+                REQUIRE(static_cast<char>(in.get()) == content[500]);
+                REQUIRE(in.seekg(-2, std::ios_base::cur));
+                REQUIRE(in.tellg() == 499);
+                REQUIRE(static_cast<char>(in.get()) == content[499]);
+                REQUIRE(in.seekg(-1, std::ios_base::end));
+                REQUIRE(static_cast<char>(in.get()) == content.back());
+                REQUIRE(in.get() == std::char_traits<char>::eof());
+                in.clear();
+                REQUIRE_FALSE(in.seekg(1001));
+            }
+
+            THEN("the stream can be reopened to stream another row")
+            {
+                in.ignore(10);
+                in.reopen(2);
+                std::string value(std::istreambuf_iterator<char>(in), {});
+                REQUIRE(value == std::string(300, '\0'));
+            }
+        }
+
+        WHEN("content is copied from a file descriptor to a blob and back")
+        {
+            std::FILE* source = std::tmpfile();
+            std::FILE* destination = std::tmpfile();
+            REQUIRE(source);
+            REQUIRE(destination);
+            REQUIRE(std::fwrite(content.data(), 1, content.size(), source) == content.size());
+            std::fflush(source);
+            std::rewind(source);
+
+            auto blob = conn.open_blob("main", "notes", "content", 1, sqlitemm::Blob::READ_WRITE);
+            auto num_copied_from = sqlitemm::copy_from(blob, fileno(source), 128);
+            auto num_copied_to = sqlitemm::copy_to(blob, fileno(destination), 128);
+
+            THEN("the content is copied in full in both directions")
+            {
+                REQUIRE(num_copied_from == content.size());
+                REQUIRE(num_copied_to == content.size());
+                REQUIRE(read_content(conn, 1) == content);
+                std::string copied(content.size(), '\0');
+                REQUIRE(lseek(fileno(destination), 0, SEEK_SET) == 0);
+                REQUIRE(read(fileno(destination), &copied[0], copied.size()) == static_cast<long>(copied.size()));
+                REQUIRE(copied == content);
+            }
+
+            THEN("copying from a shorter file stops at the end of the file")
+            {
+                blob.reopen(2);
+                REQUIRE(lseek(fileno(source), 900, SEEK_SET) == 900);
+                REQUIRE(sqlitemm::copy_from(blob, fileno(source), 64) == 100);
+            }
+
+            std::fclose(source);
+            std::fclose(destination);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::Checkpointer
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include "sqlitemm_checkpointer.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    const std::string checkpointer_filename = "checkpointer_test.db";
+
+    void remove_database_files()
+    {
+        std::remove(checkpointer_filename.c_str());
+        std::remove((checkpointer_filename + "-wal").c_str());
+        std::remove((checkpointer_filename + "-shm").c_str());
+    }
+}
+
+SCENARIO("a checkpointer runs checkpoints of a WAL mode database in the background")
+{
+    GIVEN("a writer connection attached to a checkpointer with low thresholds")
+    {
+        remove_database_files();
+        {
+            sqlitemm::Connection writer(checkpointer_filename);
+            writer.set_busy_timeout(5000);
+            writer.execute("PRAGMA journal_mode=WAL;");
+            writer.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);");
+
+            std::promise<sqlitemm::CheckpointReport> truncated;
+            bool reported = false;
+            sqlitemm::CheckpointerOptions options;
+            options.passive_threshold_frames = 4;
+            options.restart_threshold_frames = 4;
+            options.truncate_threshold_frames = 4;
+            options.interval = std::chrono::milliseconds(50);
+            options.report_callback = [&truncated, &reported](const sqlitemm::CheckpointReport& report) {
+                if (!reported && report.mode == sqlitemm::CheckpointMode::Truncate)
+                {
+                    reported = true;
+                    truncated.set_value(report);
+                }
+            };
+            sqlitemm::Checkpointer checkpointer(checkpointer_filename, options);
+            checkpointer.attach(writer);
+
+            WHEN("the writer commits transactions that grow the WAL past the thresholds")
+            {
+                auto truncated_future = truncated.get_future();
+                for (int i = 0; i < 10; ++i)
+                {
+                    writer.execute("INSERT INTO item (name) VALUES ('" + std::string(1000, 'x') + "');");
+                }
+
+                THEN("the writer no longer runs automatic checkpoints")
+                {
+                    auto stmt = writer.prepare("PRAGMA wal_autocheckpoint;");
+                    auto result = stmt.execute_query();
+                    REQUIRE(result.step());
+                    REQUIRE(static_cast<int>(result[0]) == 0);
+                }
+
+                THEN("the checkpointer checkpoints the WAL and truncates it")
+                {
+                    REQUIRE(truncated_future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+                    auto report = truncated_future.get();
+                    REQUIRE_FALSE(report.result.busy);
+                    REQUIRE(report.result.wal_frames == 0);
+
+                    auto stats = checkpointer.stats();
+                    REQUIRE(stats.checkpoints >= 2);
+                    REQUIRE(stats.checkpointed_frames > 0);
+                }
+            }
+        }
+        remove_database_files();
+    }
+}
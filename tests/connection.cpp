@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and limitations under the License.
  ************************************************************************************************************/
 
+#include <cstdio>
+#include <string>
+#include <vector>
 #include "sqlitemm.hpp"
 #include "catch.hpp"
 
@@ -193,3 +196,522 @@ SCENARIO("attach and detach non-member functions are called")
         }
     }
 }
+
+SCENARIO("prepared statements are reused through the statement cache")
+{
+    sqlitemm::Connection conn(":memory:");
+    REQUIRE_NOTHROW(conn.execute("CREATE TABLE person (id INTEGER PRIMARY KEY, name TEXT);"
+                                 "INSERT INTO person (name) VALUES ('Alice'), ('Bob');"));
+
+    WHEN("the statement cache is disabled")
+    {
+        REQUIRE(conn.statement_cache_capacity() == 0);
+        {
+            auto stmt = conn.prepare_cached("SELECT name FROM person WHERE id = ?;");
+        }
+        auto stmt = conn.prepare_cached("SELECT name FROM person WHERE id = ?;");
+
+        THEN("no cache hits or misses are counted")
+        {
+            auto stats = conn.statement_cache_stats();
+            REQUIRE(stats.hits == 0);
+            REQUIRE(stats.misses == 0);
+            REQUIRE(stats.evictions == 0);
+        }
+    }
+
+    GIVEN("a statement cache with capacity for one statement")
+    {
+        conn.set_statement_cache_capacity(1);
+        REQUIRE(conn.statement_cache_capacity() == 1);
+
+        WHEN("a cached statement is used, destroyed, and then requested again")
+        {
+            {
+                auto stmt = conn.prepare_cached("SELECT name FROM person WHERE id = ?;");
+                stmt << 1;
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+            }
+            auto stmt = conn.prepare_cached("SELECT name FROM person WHERE id = ?;");
+
+            THEN("the second request is a cache hit")
+            {
+                auto stats = conn.statement_cache_stats();
+                REQUIRE(stats.hits == 1);
+                REQUIRE(stats.misses == 1);
+                REQUIRE(stats.evictions == 0);
+            }
+
+            THEN("the reused statement has been reset and its bindings cleared")
+            {
+                auto result = stmt.execute_query();
+                REQUIRE_FALSE(result.step());
+                stmt.reset();
+                stmt << 2;
+                result = stmt.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "Bob");
+            }
+        }
+
+        WHEN("SQL with trailing whitespace is requested repeatedly")
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                conn.prepare_cached("SELECT name FROM person; ");
+            }
+
+            THEN("every request after the first is a cache hit")
+            {
+                auto stats = conn.statement_cache_stats();
+                REQUIRE(stats.hits == 2);
+                REQUIRE(stats.misses == 1);
+                REQUIRE(stats.evictions == 0);
+            }
+        }
+
+        WHEN("SQL ending with a newline is requested repeatedly")
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                auto stmt = conn.prepare_cached(R"(
+                    SELECT name
+                    FROM person
+                    WHERE id = ?;
+                )");
+                stmt << 2;
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "Bob");
+            }
+
+            THEN("every request after the first is a cache hit")
+            {
+                auto stats = conn.statement_cache_stats();
+                REQUIRE(stats.hits == 2);
+                REQUIRE(stats.misses == 1);
+                REQUIRE(stats.evictions == 0);
+            }
+        }
+
+        WHEN("the same SQL is requested while the cached statement is still in use")
+        {
+            auto stmt1 = conn.prepare_cached("SELECT name FROM person;");
+            auto stmt2 = conn.prepare_cached("SELECT name FROM person;");
+
+            THEN("both requests are cache misses")
+            {
+                auto stats = conn.statement_cache_stats();
+                REQUIRE(stats.hits == 0);
+                REQUIRE(stats.misses == 2);
+            }
+
+            THEN("returning both statements evicts one of them")
+            {
+                REQUIRE(stmt1.finalize());
+                REQUIRE(stmt2.finalize());
+                REQUIRE(conn.statement_cache_stats().evictions == 1);
+            }
+        }
+
+        WHEN("another statement is returned to the full cache")
+        {
+            conn.prepare_cached("SELECT name FROM person;");
+            conn.prepare_cached("SELECT id FROM person;");
+
+            THEN("the least recently used statement is evicted")
+            {
+                REQUIRE(conn.statement_cache_stats().evictions == 1);
+                conn.prepare_cached("SELECT id FROM person;");
+                conn.prepare_cached("SELECT name FROM person;");
+                auto stats = conn.statement_cache_stats();
+                REQUIRE(stats.hits == 1);
+                REQUIRE(stats.misses == 3);
+            }
+        }
+
+        WHEN("the connection is closed while a cached statement is in use")
+        {
+            auto stmt = conn.prepare_cached("SELECT name FROM person;");
+
+            THEN("the connection can be closed and the statement destroyed afterwards")
+            {
+                REQUIRE_NOTHROW(conn.close());
+                REQUIRE(stmt.finalize());
+            }
+        }
+
+        WHEN("the statement cache is disabled again")
+        {
+            conn.prepare_cached("SELECT name FROM person;");
+            conn.set_statement_cache_capacity(0);
+
+            THEN("the idle statement is evicted")
+            {
+                REQUIRE(conn.statement_cache_stats().evictions == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("prepared statements that outlive their database connection are finalized when it is closed")
+{
+    sqlitemm::Connection conn(":memory:");
+    REQUIRE_NOTHROW(conn.execute("CREATE TABLE person (id INTEGER PRIMARY KEY, name TEXT);"
+                                 "INSERT INTO person (name) VALUES ('Alice'), ('Bob');"));
+
+    GIVEN("many live statements, some of which have been moved or finalized out of order")
+    {
+        std::vector<sqlitemm::Statement> statements;
+        for (int i = 0; i < 100; ++i)
+        {
+            statements.push_back(conn.prepare("SELECT name FROM person WHERE id = ?;"));
+        }
+        REQUIRE(statements[10].finalize());
+        REQUIRE(statements[50].finalize());
+        statements[20] = std::move(statements[30]);
+        auto moved = std::move(statements[99]);
+        statements.erase(statements.begin() + 40, statements.begin() + 60);
+
+        WHEN("the remaining statements are still usable")
+        {
+            moved << 2;
+            auto result = moved.execute_query();
+            REQUIRE(result.step());
+            REQUIRE(static_cast<std::string>(result[0]) == "Bob");
+        }
+
+        WHEN("the database connection is moved and then closed")
+        {
+            auto other = std::move(conn);
+            REQUIRE_NOTHROW(other.close());
+
+            THEN("the statements can be finalized and destroyed afterwards")
+            {
+                REQUIRE(moved.finalize());
+                for (auto&& statement : statements)
+                {
+                    REQUIRE(statement.finalize());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("statement profiles and database status are recorded")
+{
+    GIVEN("a database connection with a populated table and profiling enabled")
+    {
+        sqlitemm::Connection conn(":memory:");
+        conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);");
+        conn.execute("INSERT INTO item (name) VALUES ('c'), ('a'), ('b');");
+        REQUIRE_FALSE(conn.profiling_enabled());
+        conn.enable_profiling();
+        REQUIRE(conn.profiling_enabled());
+
+        WHEN("a statement that scans and sorts is executed twice")
+        {
+            const std::string sql = "SELECT name FROM item ORDER BY name;";
+            auto stmt = conn.prepare(sql);
+            for (int i = 0; i < 2; ++i)
+            {
+                auto result = stmt.execute_query();
+                while (result.step())
+                {
+                }
+                stmt.reset();
+            }
+            auto other_stmt = conn.prepare(sql);
+            auto result = other_stmt.execute_query();
+            while (result.step())
+            {
+            }
+
+            THEN("executions of statements with the same SQL text are recorded in one profile")
+            {
+                auto profiles = conn.statement_profiles();
+                REQUIRE(profiles.size() == 1);
+                const auto& profile = profiles[0];
+                REQUIRE(profile.sql == sql);
+                REQUIRE(profile.calls == 3);
+                REQUIRE(profile.sorts == 3);
+                REQUIRE(profile.fullscan_steps == 6);
+                REQUIRE(profile.vm_steps > 0);
+                unsigned long long num_samples = 0;
+                for (auto count : profile.latency_histogram)
+                {
+                    num_samples += count;
+                }
+                REQUIRE(num_samples == profile.calls);
+            }
+
+            THEN("disabling profiling discards the profiles")
+            {
+                conn.disable_profiling();
+                REQUIRE_FALSE(conn.profiling_enabled());
+                REQUIRE(conn.statement_profiles().empty());
+            }
+        }
+
+        WHEN("the database status is retrieved")
+        {
+            auto status = conn.database_status();
+
+            THEN("the memory used by the connection is reported")
+            {
+                REQUIRE(status.cache_used_bytes > 0);
+                REQUIRE(status.schema_used_bytes > 0);
+            }
+        }
+    }
+}
+
+SCENARIO("connection options are applied when the database connection is opened")
+{
+    GIVEN("options for the lookaside memory, page cache, memory-mapped I/O, temporary storage and journal")
+    {
+        const char* const filename = "connection_options_test.db";
+        std::remove(filename);
+        sqlitemm::ConnectionOptions options;
+        options.lookaside_slot_size = 256;
+        options.lookaside_slot_count = 128;
+        options.lookaside_arena = true;
+        options.cache_size = -4096;
+        options.mmap_size = 1 << 20;
+        options.temp_store = sqlitemm::TempStore::Memory;
+        options.journal_mode = sqlitemm::JournalMode::Wal;
+        options.synchronous = sqlitemm::Synchronous::Normal;
+
+        WHEN("a database connection is opened with the options")
+        {
+            {
+                sqlitemm::Connection conn(filename, options);
+                conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);");
+                auto pragma_value = [&conn](const std::string& pragma) {
+                    auto stmt = conn.prepare("PRAGMA " + pragma + ";");
+                    auto result = stmt.execute_query();
+                    REQUIRE(result.step());
+                    return static_cast<std::string>(result[0]);
+                };
+
+                THEN("each option is in effect")
+                {
+                    REQUIRE(pragma_value("cache_size") == "-4096");
+                    REQUIRE(pragma_value("mmap_size") == "1048576");
+                    REQUIRE(pragma_value("temp_store") == "2");
+                    REQUIRE(pragma_value("journal_mode") == "wal");
+                    REQUIRE(pragma_value("synchronous") == "1");
+                    REQUIRE(conn.database_status().lookaside_hits > 0);
+                }
+            }
+            std::remove(filename);
+            std::remove("connection_options_test.db-wal");
+            std::remove("connection_options_test.db-shm");
+        }
+
+        WHEN("the database cannot be opened with the options")
+        {
+            options.flags = SQLITE_OPEN_READONLY;
+
+            THEN("an exception is thrown")
+            {
+                REQUIRE_THROWS_AS(sqlitemm::Connection(filename, options), sqlitemm::Error);
+            }
+        }
+    }
+
+    GIVEN("a database connection that is open")
+    {
+        sqlitemm::Connection conn(":memory:");
+
+        WHEN("a page cache arena is configured after SQLite has been initialized")
+        {
+            THEN("the misuse is reported")
+            {
+                try
+                {
+                    sqlitemm::configure_page_cache(4096 + 128, 64);
+                    FAIL("configure_page_cache did not throw");
+                }
+                catch (const sqlitemm::Error& e)
+                {
+                    REQUIRE(e.code() == SQLITE_MISUSE);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("WAL checkpoints can be run and configured")
+{
+    GIVEN("a database connection to a database in WAL mode")
+    {
+        const char* filename = "connection_checkpoint_test.db";
+        {
+            sqlitemm::Connection conn(filename);
+            conn.execute("PRAGMA journal_mode=WAL;");
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);");
+
+            WHEN("automatic checkpoints are disabled and rows are inserted")
+            {
+                conn.set_wal_autocheckpoint(0);
+                for (int i = 0; i < 10; ++i)
+                {
+                    conn.execute("INSERT INTO item (name) VALUES ('" + std::string(1000, 'x') + "');");
+                }
+
+                THEN("the WAL grows until a checkpoint is run, and a truncate checkpoint empties it")
+                {
+                    auto passive = conn.checkpoint();
+                    REQUIRE(passive.wal_frames > 0);
+                    REQUIRE(passive.checkpointed_frames == passive.wal_frames);
+                    REQUIRE_FALSE(passive.busy);
+
+                    auto truncate = conn.checkpoint(sqlitemm::CheckpointMode::Truncate, "main");
+                    REQUIRE(truncate.wal_frames == 0);
+                    REQUIRE(truncate.checkpointed_frames == 0);
+                    REQUIRE_FALSE(truncate.busy);
+                }
+            }
+
+            WHEN("a WAL hook is set and transactions are committed")
+            {
+                int calls = 0;
+                int last_wal_frames = 0;
+                std::string last_schema_name;
+                conn.set_wal_hook([&](const char* schema_name, int wal_frames) {
+                    ++calls;
+                    last_schema_name = schema_name;
+                    last_wal_frames = wal_frames;
+                });
+                conn.execute("INSERT INTO item (name) VALUES ('a');");
+                conn.execute("INSERT INTO item (name) VALUES ('b');");
+
+                THEN("the hook is called after each commit with the size of the WAL")
+                {
+                    REQUIRE(calls == 2);
+                    REQUIRE(last_schema_name == "main");
+                    REQUIRE(last_wal_frames > 0);
+                }
+
+                AND_WHEN("the hook is removed")
+                {
+                    conn.set_wal_hook(nullptr);
+                    conn.execute("INSERT INTO item (name) VALUES ('c');");
+
+                    THEN("it is no longer called")
+                    {
+                        REQUIRE(calls == 2);
+                    }
+                }
+            }
+        }
+        std::remove(filename);
+        std::remove("connection_checkpoint_test.db-wal");
+        std::remove("connection_checkpoint_test.db-shm");
+    }
+
+    GIVEN("a database connection to a database not in WAL mode")
+    {
+        sqlitemm::Connection conn(":memory:");
+
+        WHEN("a checkpoint is run")
+        {
+            auto result = conn.checkpoint(sqlitemm::CheckpointMode::Full);
+
+            THEN("the result reports that there is no WAL")
+            {
+                REQUIRE(result.wal_frames == -1);
+                REQUIRE(result.checkpointed_frames == -1);
+                REQUIRE_FALSE(result.busy);
+            }
+        }
+    }
+}
+
+SCENARIO("databases can be opened as read-only snapshots")
+{
+    GIVEN("a database file with rows, whose name has characters reserved in URIs")
+    {
+        const char* filename = "connection_snapshot_test#1.db";
+        {
+            sqlitemm::Connection conn(filename);
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);"
+                         "INSERT INTO item (name) VALUES ('a'), ('b'), ('c');");
+        }
+
+        WHEN("the database is opened as a read-only snapshot")
+        {
+            {
+                sqlitemm::Connection conn;
+                conn.open_readonly_snapshot(filename);
+
+                THEN("it can be queried with the file memory-mapped, but not written to")
+                {
+                    auto stmt = conn.prepare("SELECT COUNT(*) FROM item;");
+                    auto result = stmt.execute_query();
+                    REQUIRE(result.step());
+                    REQUIRE(static_cast<int>(result[0]) == 3);
+
+                    auto mmap_size = conn.prepare("PRAGMA mmap_size;");
+                    auto mmap_result = mmap_size.execute_query();
+                    REQUIRE(mmap_result.step());
+                    REQUIRE(static_cast<long long>(mmap_result[0]) > 0);
+
+                    try
+                    {
+                        conn.execute("INSERT INTO item (name) VALUES ('d');");
+                        FAIL("writing to a read-only snapshot did not throw");
+                    }
+                    catch (const sqlitemm::Error& e)
+                    {
+                        REQUIRE(e.code() == SQLITE_READONLY);
+                    }
+                }
+            }
+            std::remove(filename);
+        }
+    }
+
+    GIVEN("the image of a database in memory")
+    {
+        std::vector<unsigned char> image;
+        {
+            sqlitemm::Connection conn(":memory:");
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);"
+                         "INSERT INTO item (name) VALUES ('a'), ('b');");
+            auto stmt = conn.prepare("VACUUM INTO 'connection_snapshot_image_test.db';");
+            stmt.execute();
+            auto file = std::fopen("connection_snapshot_image_test.db", "rb");
+            REQUIRE(file);
+            unsigned char buffer[4096];
+            for (std::size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;)
+            {
+                image.insert(image.end(), buffer, buffer + n);
+            }
+            std::fclose(file);
+            std::remove("connection_snapshot_image_test.db");
+        }
+
+        WHEN("several database connections are opened as read-only snapshots of the image")
+        {
+            sqlitemm::Connection first;
+            first.open_readonly_snapshot(image.data(), image.size());
+            sqlitemm::Connection second;
+            second.open_readonly_snapshot(image.data(), image.size());
+
+            THEN("each can query the image, but not write to it")
+            {
+                for (auto* conn : {&first, &second})
+                {
+                    auto stmt = conn->prepare("SELECT group_concat(name) FROM item;");
+                    auto result = stmt.execute_query();
+                    REQUIRE(result.step());
+                    REQUIRE(static_cast<std::string>(result[0]) == "a,b");
+                    REQUIRE_THROWS_AS(conn->execute("DELETE FROM item;"), sqlitemm::Error);
+                }
+            }
+        }
+    }
+}
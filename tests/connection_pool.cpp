@@ -0,0 +1,176 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::ConnectionPool
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sqlitemm_pool.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    const std::string pool_filename = "connection_pool_test.db";
+
+    void remove_database_files()
+    {
+        std::remove(pool_filename.c_str());
+        std::remove((pool_filename + "-wal").c_str());
+        std::remove((pool_filename + "-shm").c_str());
+    }
+}
+
+SCENARIO("connection pools lease reader and writer connections to a WAL mode database")
+{
+    GIVEN("a connection pool with a table created through the writer")
+    {
+        remove_database_files();
+        {
+            std::atomic<int> setup_count{0};
+            sqlitemm::ConnectionPool pool(
+                pool_filename,
+                3,
+                [&setup_count](sqlitemm::Connection& conn) {
+                    conn.execute("PRAGMA cache_size=-512;");
+                    ++setup_count;
+                }
+            );
+            {
+                auto writer = pool.acquire_writer();
+                REQUIRE_NOTHROW(writer->execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT);"
+                                                "INSERT INTO item (name) VALUES ('ball'), ('cup');"));
+            }
+
+            WHEN("the pool is constructed")
+            {
+                THEN("every connection is set up and the database is in WAL journal mode")
+                {
+                    REQUIRE(pool.reader_count() == 3);
+                    REQUIRE(setup_count == 4);
+                    auto reader = pool.acquire_reader();
+                    auto statement = reader->prepare("PRAGMA journal_mode;");
+                    auto result = statement.execute_query();
+                    REQUIRE(result.step());
+                    REQUIRE(static_cast<std::string>(result[0]) == "wal");
+                }
+            }
+
+            WHEN("every reader is leased")
+            {
+                std::vector<sqlitemm::ConnectionPool::Lease> leases;
+                for (size_t i = 0; i < pool.reader_count(); ++i)
+                {
+                    leases.push_back(pool.acquire_reader());
+                }
+
+                THEN("no more readers can be leased until one is returned")
+                {
+                    REQUIRE(leases[0]);
+                    REQUIRE(&*leases[0] != &*leases[1]);
+                    REQUIRE_FALSE(pool.try_acquire_reader());
+                    leases.pop_back();
+                    REQUIRE(pool.try_acquire_reader());
+                }
+
+                THEN("a waiting reader is given the returned reader")
+                {
+                    sqlitemm::Connection* returned = &*leases[1];
+                    sqlitemm::Connection* acquired = nullptr;
+                    std::thread waiter([&pool, &acquired] {
+                        auto lease = pool.acquire_reader();
+                        acquired = &*lease;
+                    });
+                    leases[1].release();
+                    waiter.join();
+                    REQUIRE(acquired == returned);
+                }
+            }
+
+            WHEN("the writer is leased")
+            {
+                auto writer = pool.acquire_writer();
+
+                THEN("it cannot be leased again until it is returned")
+                {
+                    REQUIRE_FALSE(pool.try_acquire_writer());
+                    writer.release();
+                    REQUIRE_FALSE(writer);
+                    REQUIRE(pool.try_acquire_writer());
+                }
+            }
+
+            WHEN("readers are leased concurrently from many threads")
+            {
+                std::atomic<int> rows_read{0};
+                std::vector<std::thread> threads;
+                for (int i = 0; i < 8; ++i)
+                {
+                    threads.emplace_back([&pool, &rows_read] {
+                        for (int j = 0; j < 50; ++j)
+                        {
+                            auto reader = pool.acquire_reader();
+                            auto statement = reader->prepare_cached("SELECT COUNT(*) FROM item;");
+                            auto result = statement.execute_query();
+                            if (result.step())
+                            {
+                                rows_read += static_cast<int>(result[0]);
+                            }
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+
+                THEN("every query sees the rows committed by the writer")
+                {
+                    REQUIRE(rows_read == 8 * 50 * 2);
+                }
+            }
+
+            WHEN("a reader attempts to write")
+            {
+                auto reader = pool.acquire_reader();
+
+                THEN("an error is thrown because it is read-only")
+                {
+                    REQUIRE_THROWS_AS(reader->execute("INSERT INTO item (name) VALUES ('plate');"), sqlitemm::Error);
+                }
+            }
+        }
+        remove_database_files();
+    }
+}
+
+SCENARIO("connection pools must have at least one reader")
+{
+    GIVEN("a reader count of zero")
+    {
+        remove_database_files();
+
+        WHEN("a connection pool is constructed")
+        {
+            THEN("std::invalid_argument is thrown")
+            {
+                REQUIRE_THROWS_AS(sqlitemm::ConnectionPool(pool_filename, 0), std::invalid_argument);
+            }
+        }
+
+        remove_database_files();
+    }
+}
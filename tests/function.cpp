@@ -0,0 +1,235 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing SQL functions created through sqlitemm::Connection
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include "sqlitemm.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    long long add(long long a, long long b)
+    {
+        return a + b;
+    }
+
+    struct Average
+    {
+        double sum = 0.0;
+        int count = 0;
+
+        void step(std::optional<double> value)
+        {
+            if (value)
+            {
+                sum += *value;
+                ++count;
+            }
+        }
+
+        std::optional<double> finalize() const
+        {
+            return count > 0 ? std::optional<double>(sum / count) : std::nullopt;
+        }
+    };
+
+    struct Concatenation
+    {
+        std::string text;
+
+        void step(std::string_view value, std::string_view separator)
+        {
+            if (!text.empty())
+            {
+                text += separator;
+            }
+            text += value;
+        }
+
+        std::string finalize()
+        {
+            return text;
+        }
+    };
+
+    template<typename T>
+    T select_value(sqlitemm::Connection& conn, const std::string& sql)
+    {
+        auto stmt = conn.prepare(sql);
+        auto result = stmt.execute_query();
+        REQUIRE(result.step());
+        return std::get<0>(result.row<T>());
+    }
+}
+
+SCENARIO("scalar SQL functions can be created from callables")
+{
+    GIVEN("a database connection")
+    {
+        sqlitemm::Connection conn(":memory:");
+
+        WHEN("a function pointer is registered as a deterministic SQL function")
+        {
+            conn.create_function("add_integers", &add, SQLITE_DETERMINISTIC);
+
+            THEN("the arguments and return value are converted to and from their SQL values")
+            {
+                REQUIRE(select_value<long long>(conn, "SELECT add_integers(40, 2);") == 42);
+                REQUIRE(select_value<long long>(conn, "SELECT add_integers('3000000000', 1);") == 3000000001LL);
+            }
+
+            THEN("the number of arguments is enforced")
+            {
+                REQUIRE_THROWS_AS(conn.prepare("SELECT add_integers(1);"), sqlitemm::Error);
+            }
+        }
+
+        WHEN("a lambda with state and view arguments is registered as a SQL function")
+        {
+            int num_calls = 0;
+            conn.create_function("shout", [&num_calls](std::string_view text, bool enabled) {
+                ++num_calls;
+                std::string shouted(text);
+                if (enabled)
+                {
+                    shouted += '!';
+                }
+                return shouted;
+            });
+
+            THEN("it is called once per row with its state preserved")
+            {
+                REQUIRE(select_value<std::string>(conn, "SELECT shout('hello', 1);") == "hello!");
+                REQUIRE(select_value<std::string>(conn, "SELECT shout('hello', 0);") == "hello");
+                REQUIRE(num_calls == 2);
+            }
+        }
+
+        WHEN("SQL functions taking and returning optional values and BLOBs are registered")
+        {
+            conn.create_function("double_or_null", [](std::optional<int> value) -> std::optional<int> {
+                return value ? std::optional<int>(*value * 2) : std::nullopt;
+            });
+            conn.create_function("blob_length", [](sqlitemm::BlobView blob) { return blob.size(); });
+            conn.create_function("blob_to_text", [](sqlitemm::BlobView blob) {
+                return std::string(blob.begin(), blob.end()).append("!");
+            });
+
+            THEN("NULL maps to an empty optional value and back")
+            {
+                REQUIRE(select_value<int>(conn, "SELECT double_or_null(21);") == 42);
+                REQUIRE(select_value<std::optional<int>>(conn, "SELECT double_or_null(NULL);") == std::nullopt);
+                REQUIRE(select_value<int>(conn, "SELECT blob_length(x'00010203');") == 4);
+                REQUIRE(select_value<std::string>(conn, "SELECT blob_to_text(x'6869');") == "hi!");
+            }
+        }
+
+        WHEN("a SQL function returning an empty default constructed string view is registered")
+        {
+            conn.create_function("empty_view", [](int) { return std::string_view(); });
+
+            THEN("the result is empty text rather than NULL")
+            {
+                REQUIRE(select_value<std::optional<std::string>>(conn, "SELECT empty_view(0);") == std::string());
+                REQUIRE(select_value<std::string>(conn, "SELECT typeof(empty_view(0));") == "text");
+            }
+        }
+
+        WHEN("a SQL function cannot be registered because its name is too long")
+        {
+            auto token = std::make_shared<int>(0);
+            auto register_function = [&conn, &token] {
+                conn.create_function(std::string(300, 'f'), [token](int value) { return value + *token; });
+            };
+
+            THEN("sqlitemm::Error is thrown and the callable is destroyed")
+            {
+                REQUIRE_THROWS_AS(register_function(), sqlitemm::Error);
+                REQUIRE(token.use_count() == 1);
+            }
+        }
+
+        WHEN("a SQL function that throws an exception is called")
+        {
+            conn.create_function("fail", [](int code) -> int {
+                if (code == 0)
+                {
+                    throw std::runtime_error("failure requested");
+                }
+                throw sqlitemm::Error("constraint violation requested", SQLITE_CONSTRAINT);
+            });
+            auto stmt = conn.prepare("SELECT fail(:code);");
+
+            THEN("the exception is reported as an error by the statement")
+            {
+                stmt[":code"] = 0;
+                auto result = stmt.execute_query();
+                REQUIRE_THROWS_WITH(result.step(), Catch::Contains("failure requested"));
+                REQUIRE_THROWS_AS(stmt.reset(), sqlitemm::Error);
+                stmt[":code"] = 1;
+                auto other_result = stmt.execute_query();
+                REQUIRE_THROWS_AS(other_result.step(), sqlitemm::ConstraintError);
+            }
+        }
+    }
+}
+
+SCENARIO("aggregate SQL functions can be created from state types")
+{
+    GIVEN("a database connection with a table of values")
+    {
+        sqlitemm::Connection conn(":memory:");
+        conn.execute(
+            "CREATE TABLE item (category TEXT, name TEXT, price REAL);"
+            "INSERT INTO item VALUES ('fruit', 'apple', 1.0), ('fruit', 'pear', 2.0), ('fruit', 'fig', NULL),"
+            " ('vegetable', 'leek', 4.0);"
+        );
+
+        WHEN("aggregate SQL functions are registered")
+        {
+            conn.create_aggregate<Average>("average", SQLITE_DETERMINISTIC);
+            conn.create_aggregate<Concatenation>("concatenate");
+
+            THEN("each group is aggregated in its own state")
+            {
+                auto stmt = conn.prepare(
+                    "SELECT category, average(price), concatenate(name, ',') FROM item GROUP BY category"
+                    " ORDER BY category;"
+                );
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "fruit");
+                REQUIRE(static_cast<double>(result[1]) == Approx(1.5));
+                REQUIRE(static_cast<std::string>(result[2]) == "apple,pear,fig");
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "vegetable");
+                REQUIRE(static_cast<double>(result[1]) == Approx(4.0));
+                REQUIRE(static_cast<std::string>(result[2]) == "leek");
+                REQUIRE_FALSE(result.step());
+            }
+
+            THEN("an aggregate over no rows finalizes a default constructed state")
+            {
+                REQUIRE(select_value<std::optional<double>>(conn, "SELECT average(price) FROM item WHERE 0;")
+                        == std::nullopt);
+                REQUIRE(select_value<std::string>(conn, "SELECT concatenate(name, ',') FROM item WHERE 0;").empty());
+            }
+        }
+    }
+}
@@ -15,8 +15,10 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 #include "sqlitemm.hpp"
@@ -526,3 +528,377 @@ TEST_CASE("Result conversions")
         }
     }
 }
+
+SCENARIO("results can be decoded into tuples and structs with types resolved at compile time")
+{
+    GIVEN("a database connection with a table created and populated")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, quantity INTEGER, price REAL);"
+                         "INSERT INTO item (name, quantity, price) VALUES "
+                         "('ball', 2, 1.23), ('cup', NULL, 4.56), (NULL, 3, 7.89);")
+        );
+        auto statement = conn.prepare("SELECT name, quantity, price FROM item ORDER BY id;");
+
+        WHEN("the current row is decoded into a tuple")
+        {
+            auto result = statement.execute_query();
+            REQUIRE(result.step());
+            auto row = result.row<std::string, int, double>();
+
+            THEN("the fields are converted to the tuple element types")
+            {
+                REQUIRE(std::get<0>(row) == "ball");
+                REQUIRE(std::get<1>(row) == 2);
+                REQUIRE(std::get<2>(row) == Approx(1.23));
+            }
+
+            THEN("the current field for stream operators is not advanced")
+            {
+                std::string name;
+                REQUIRE_NOTHROW(result >> name);
+                REQUIRE(name == "ball");
+            }
+        }
+
+        WHEN("the rows are iterated over as tuples")
+        {
+            auto result = statement.execute_query();
+            std::vector<std::tuple<std::optional<std::string>, std::optional<long long>, float>> rows;
+            for (auto row : result.rows<std::optional<std::string>, std::optional<long long>, float>())
+            {
+                rows.push_back(row);
+            }
+
+            THEN("every remaining row is decoded, with NULL decoded as an empty std::optional")
+            {
+                REQUIRE(rows.size() == 3);
+                REQUIRE(*std::get<0>(rows[0]) == "ball");
+                REQUIRE(*std::get<1>(rows[0]) == 2);
+                REQUIRE(std::get<2>(rows[0]) == Approx(1.23f));
+                REQUIRE(*std::get<0>(rows[1]) == "cup");
+                REQUIRE_FALSE(std::get<1>(rows[1]).has_value());
+                REQUIRE_FALSE(std::get<0>(rows[2]).has_value());
+                REQUIRE(*std::get<1>(rows[2]) == 3);
+            }
+        }
+
+        WHEN("the rows are iterated over as structs")
+        {
+            struct Item
+            {
+                double price;
+                std::string name;
+                int quantity;
+            };
+            auto result = statement.execute_query();
+            auto items = result.as<Item>(&Item::name, &Item::quantity, &Item::price);
+            std::vector<Item> rows(items.begin(), items.end());
+
+            THEN("the fields are assigned to the data members in sequence")
+            {
+                REQUIRE(rows.size() == 3);
+                REQUIRE(rows[0].name == "ball");
+                REQUIRE(rows[0].quantity == 2);
+                REQUIRE(rows[0].price == Approx(1.23));
+                REQUIRE(rows[1].name == "cup");
+                REQUIRE(rows[1].quantity == 0);
+                REQUIRE(rows[2].name.empty());
+                REQUIRE(rows[2].price == Approx(7.89));
+            }
+        }
+
+        WHEN("strict typing is enabled and a field is decoded to a different type")
+        {
+            auto result = statement.execute_query(true);
+            REQUIRE(result.step());
+
+            THEN("TypeError is thrown")
+            {
+                REQUIRE_THROWS_AS((result.row<int, int, double>()), sqlitemm::TypeError);
+                REQUIRE_NOTHROW(result.row<std::string, int, double>());
+            }
+
+            THEN("NullTypeError is thrown for NULL unless std::optional is used")
+            {
+                REQUIRE(result.step());
+                REQUIRE_THROWS_AS((result.row<std::string, int>()), sqlitemm::NullTypeError);
+                REQUIRE_NOTHROW(result.row<std::string, std::optional<int>>());
+            }
+        }
+    }
+}
+
+SCENARIO("results can be retrieved as views without copying")
+{
+    GIVEN("a database connection with a table created and populated")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, data BLOB);"
+                         "INSERT INTO item (name, data) VALUES ('ball', x'0102ff'), ('', x''), (NULL, NULL);")
+        );
+        auto statement = conn.prepare("SELECT name, data FROM item ORDER BY id;");
+
+        WHEN("the fields are retrieved as views using result fields")
+        {
+            auto result = statement.execute_query();
+            REQUIRE(result.step());
+            std::string_view name = result[0];
+            sqlitemm::BlobView data = result[1];
+
+            THEN("the views refer to the field contents")
+            {
+                const unsigned char expected[] = {0x01, 0x02, 0xff};
+                REQUIRE(name == "ball");
+                REQUIRE(data.size() == 3);
+                REQUIRE(data == sqlitemm::BlobView(expected, sizeof(expected)));
+                REQUIRE(std::vector<unsigned char>(data.begin(), data.end()) ==
+                        std::vector<unsigned char>{0x01, 0x02, 0xff});
+                REQUIRE(data[2] == 0xff);
+            }
+
+            THEN("empty and NULL fields are retrieved as empty views")
+            {
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string_view>(result[0]).empty());
+                REQUIRE(static_cast<sqlitemm::BlobView>(result[1]).empty());
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string_view>(result[0]).empty());
+                REQUIRE(static_cast<sqlitemm::BlobView>(result[1]).data() == nullptr);
+            }
+        }
+
+        WHEN("the fields are retrieved as views using stream operators")
+        {
+            auto result = statement.execute_query();
+            REQUIRE(result.step());
+            std::string_view name;
+            sqlitemm::BlobView data;
+            result >> name >> data;
+
+            THEN("the views refer to the field contents")
+            {
+                REQUIRE(name == "ball");
+                REQUIRE(data.size() == 3);
+                REQUIRE(data[0] == 0x01);
+            }
+        }
+
+        WHEN("the rows are decoded into tuples of views")
+        {
+            auto result = statement.execute_query();
+            REQUIRE(result.step());
+            auto row = result.row<std::string_view, sqlitemm::BlobView>();
+
+            THEN("the tuple elements refer to the field contents")
+            {
+                REQUIRE(std::get<0>(row) == "ball");
+                REQUIRE(std::get<1>(row).size() == 3);
+            }
+        }
+
+        WHEN("strict typing is enabled and a field is retrieved as a view of a different type")
+        {
+            auto result = statement.execute_query(true);
+            REQUIRE(result.step());
+
+            THEN("TypeError is thrown")
+            {
+                REQUIRE_THROWS_AS(static_cast<sqlitemm::BlobView>(result[0]), sqlitemm::TypeError);
+                REQUIRE_THROWS_AS(static_cast<std::string_view>(result[1]), sqlitemm::TypeError);
+                REQUIRE_NOTHROW(static_cast<std::string_view>(result[0]));
+            }
+        }
+    }
+}
+
+SCENARIO("results can be retrieved by column name along with column metadata")
+{
+    GIVEN("a database connection with a table created and populated")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, quantity INTEGER, price REAL);"
+                         "INSERT INTO item (name, quantity, price) VALUES ('ball', 2, 1.23), ('cup', 5, 4.56);")
+        );
+        auto statement = conn.prepare(
+            "SELECT name, quantity AS amount, price * quantity AS total, id AS name FROM item ORDER BY id;"
+        );
+
+        WHEN("fields are retrieved by column name")
+        {
+            auto result = statement.execute_query();
+            std::vector<std::string> names;
+            std::vector<int> amounts;
+            while (result.step())
+            {
+                names.push_back(result["name"]);
+                amounts.push_back(result["amount"]);
+            }
+
+            THEN("the fields of the named columns are retrieved, using the leftmost of duplicate names")
+            {
+                REQUIRE(names == std::vector<std::string>{"ball", "cup"});
+                REQUIRE(amounts == std::vector<int>{2, 5});
+                REQUIRE(result.column_index("total") == 2);
+            }
+        }
+
+        WHEN("a column name that does not exist is looked up")
+        {
+            auto result = statement.execute_query();
+            REQUIRE(result.step());
+
+            THEN("an error is thrown")
+            {
+                REQUIRE_THROWS_AS(result["price"], sqlitemm::Error);
+                REQUIRE_THROWS_AS(result.column_index("Name"), sqlitemm::Error);
+            }
+        }
+
+        WHEN("the column metadata is retrieved")
+        {
+            auto result = statement.execute_query();
+
+            THEN("the names, declared types and origins of the columns are available before stepping")
+            {
+                REQUIRE(result.column_count() == 4);
+                auto& columns = result.columns();
+                REQUIRE(columns.size() == 4);
+                REQUIRE(columns[1].name == "amount");
+                REQUIRE(columns[1].declared_type == "INTEGER");
+                REQUIRE(columns[1].database_name == "main");
+                REQUIRE(columns[1].table_name == "item");
+                REQUIRE(columns[1].origin_name == "quantity");
+                REQUIRE(result.column(2).name == "total");
+                REQUIRE(result.column(2).declared_type.empty());
+                REQUIRE(result.column(2).table_name.empty());
+                REQUIRE(&result.columns() == &columns);
+            }
+        }
+    }
+}
+
+SCENARIO("results can be fetched in batches stored column by column")
+{
+    GIVEN("a database connection with a table created and populated")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, quantity INTEGER, price REAL, data BLOB);"
+                         "INSERT INTO item (name, quantity, price, data) VALUES "
+                         "('ball', 2, 1.5, x'01'), (NULL, 3, 2.5, NULL), ('cup', NULL, 3.5, x'0203'), "
+                         "('', 4, NULL, x''), ('plate', 5, 4.5, x'04');")
+        );
+        auto statement = conn.prepare("SELECT name, quantity, price, data FROM item ORDER BY id;");
+
+        WHEN("the result set is fetched in batches with the column storage types inferred")
+        {
+            auto result = statement.execute_query();
+            sqlitemm::ColumnBatch batch;
+            REQUIRE(result.fetch_columns(batch, 3) == 3);
+
+            THEN("the first batch holds the first rows in typed column buffers")
+            {
+                REQUIRE(batch.size() == 3);
+                REQUIRE(batch.column_count() == 4);
+                REQUIRE(batch[0].type() == SQLITE_TEXT);
+                REQUIRE(batch[1].type() == SQLITE_INTEGER);
+                REQUIRE(batch[2].type() == SQLITE_FLOAT);
+                REQUIRE(batch[3].type() == SQLITE_BLOB);
+                REQUIRE(batch[0].text(0) == "ball");
+                REQUIRE(batch[0].is_null(1));
+                REQUIRE(batch[0].text(1).empty());
+                REQUIRE(batch[0].text(2) == "cup");
+                REQUIRE(batch[0].offsets() == std::vector<size_t>{0, 4, 4, 7});
+                REQUIRE(batch[1].integers() == std::vector<std::int64_t>{2, 3, 0});
+                REQUIRE_FALSE(batch[1].is_null(1));
+                REQUIRE(batch[1].is_null(2));
+                REQUIRE(batch[1].null_bitmap()[0] == 4);
+                REQUIRE(batch[2].reals() == std::vector<double>{1.5, 2.5, 3.5});
+                REQUIRE(batch[3].blob(2).size() == 2);
+                REQUIRE(batch[3].blob(2)[1] == 0x03);
+            }
+
+            THEN("the next batch holds the remaining rows, with the buffers reused")
+            {
+                auto integers_data = batch[1].integers().data();
+                REQUIRE(result.fetch_columns(batch, 3) == 2);
+                REQUIRE(batch.size() == 2);
+                REQUIRE(batch[1].integers().data() == integers_data);
+                REQUIRE(batch[1].integers() == std::vector<std::int64_t>{4, 5});
+                REQUIRE(batch[0].text(0).empty());
+                REQUIRE_FALSE(batch[0].is_null(0));
+                REQUIRE(batch[2].is_null(0));
+                REQUIRE(batch[0].text(1) == "plate");
+                REQUIRE(result.fetch_columns(batch, 3) == 0);
+                REQUIRE(batch.empty());
+            }
+        }
+
+        WHEN("the result set is fetched with explicit column storage types")
+        {
+            auto result = statement.execute_query();
+            sqlitemm::ColumnBatch batch({SQLITE_TEXT, SQLITE_FLOAT, SQLITE_INTEGER, SQLITE_BLOB});
+            REQUIRE(result.fetch_columns(batch, 10) == 5);
+
+            THEN("the fields are converted to the storage types")
+            {
+                REQUIRE(batch[1].reals() == std::vector<double>{2.0, 3.0, 0.0, 4.0, 5.0});
+                REQUIRE(batch[2].integers() == std::vector<std::int64_t>{1, 2, 3, 0, 4});
+            }
+        }
+
+        WHEN("strict typing is enabled and a field does not match its column storage type")
+        {
+            auto result = statement.execute_query(true);
+            sqlitemm::ColumnBatch batch({SQLITE_TEXT, SQLITE_FLOAT, SQLITE_FLOAT, SQLITE_BLOB});
+
+            THEN("TypeError is thrown")
+            {
+                REQUIRE_THROWS_AS(result.fetch_columns(batch, 10), sqlitemm::TypeError);
+            }
+        }
+
+        WHEN("the batch has explicit column storage types for fewer columns than the result set")
+        {
+            auto result = statement.execute_query();
+            sqlitemm::ColumnBatch batch({SQLITE_TEXT, SQLITE_INTEGER});
+
+            THEN("sqlitemm::Error is thrown with SQLITE_RANGE and no rows are fetched")
+            {
+                try
+                {
+                    result.fetch_columns(batch, 10);
+                    FAIL("fetch_columns did not throw");
+                }
+                catch (const sqlitemm::Error& e)
+                {
+                    REQUIRE(e.code() == SQLITE_RANGE);
+                }
+                REQUIRE(batch.empty());
+                REQUIRE(result.step());
+            }
+        }
+
+        WHEN("strict typing is enabled and a later field of a later row does not match its column storage type")
+        {
+            REQUIRE_NOTHROW(conn.execute("UPDATE item SET price = 'free' WHERE id = 2;"));
+            auto result = statement.execute_query(true);
+            sqlitemm::ColumnBatch batch({SQLITE_TEXT, SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_BLOB});
+
+            THEN("TypeError is thrown with only the rows before it in the batch, with columns of equal length")
+            {
+                REQUIRE_THROWS_AS(result.fetch_columns(batch, 10), sqlitemm::TypeError);
+                REQUIRE(batch.size() == 1);
+                REQUIRE(batch[0].offsets() == std::vector<size_t>{0, 4});
+                REQUIRE(batch[0].null_bitmap()[0] == 0);
+                REQUIRE(batch[1].integers() == std::vector<std::int64_t>{2});
+                REQUIRE(batch[2].reals() == std::vector<double>{1.5});
+                REQUIRE(batch[3].offsets() == std::vector<size_t>{0, 1});
+            }
+        }
+    }
+}
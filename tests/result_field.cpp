@@ -15,7 +15,9 @@
 
 #include <algorithm>
 #include <array>
+#include <optional>
 #include <string>
+#include <tuple>
 #include "sqlitemm.hpp"
 #include "catch.hpp"
 
@@ -262,3 +264,57 @@ TEST_CASE("ResultField conversions")
         }
     }
 }
+
+SCENARIO("result field types are retrieved when needed")
+{
+    GIVEN("a result row with fields of each fundamental type")
+    {
+        sqlitemm::Connection conn(":memory:");
+        auto stmt = conn.prepare("SELECT 1, 2.5, 'text', x'01', NULL;");
+
+        WHEN("the types of the fields are retrieved")
+        {
+            auto result = stmt.execute_query();
+            REQUIRE(result.step());
+
+            THEN("each field reports its type")
+            {
+                REQUIRE(result[0].type() == SQLITE_INTEGER);
+                REQUIRE(result[1].type() == SQLITE_FLOAT);
+                REQUIRE(result[2].type() == SQLITE_TEXT);
+                REQUIRE(result[3].type() == SQLITE_BLOB);
+                REQUIRE(result[4].type() == SQLITE_NULL);
+            }
+
+            THEN("a type retrieved before a conversion is retained after it")
+            {
+                auto field = result[0];
+                REQUIRE(field.type() == SQLITE_INTEGER);
+                REQUIRE(static_cast<std::string>(field) == "1");
+                REQUIRE(field.type() == SQLITE_INTEGER);
+            }
+        }
+
+        WHEN("a whole row is decoded with strict typing")
+        {
+            auto result = stmt.execute_query(true);
+            REQUIRE(result.step());
+
+            THEN("fields of the expected types, including NULL as an empty optional, are decoded")
+            {
+                auto row = result.row<int, double, std::string, sqlitemm::BlobView, std::optional<int>>();
+                REQUIRE(std::get<0>(row) == 1);
+                REQUIRE(std::get<1>(row) == 2.5);
+                REQUIRE(std::get<2>(row) == "text");
+                REQUIRE(std::get<3>(row).size() == 1);
+                REQUIRE_FALSE(std::get<4>(row).has_value());
+            }
+
+            THEN("a field of an unexpected type throws TypeError")
+            {
+                REQUIRE_THROWS_AS((result.row<int, double, std::optional<int>, sqlitemm::BlobView, int>()),
+                                  sqlitemm::TypeError);
+            }
+        }
+    }
+}
@@ -0,0 +1,258 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::ResultWriter
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "sqlitemm_result_writer.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    const char* values_sql =
+        "SELECT 1 AS id, 'plain' AS name, 2.5 AS score, NULL AS note, x'00FF10' AS data "
+        "UNION ALL SELECT -42, 'has \"quotes\", comma', 1e100, 'line\nbreak', x'' ORDER BY id DESC;";
+
+    std::string write_to_string(sqlitemm::Connection& conn, const std::string& sql, sqlitemm::ResultWriterOptions options)
+    {
+        std::string output;
+        sqlitemm::ResultWriter writer([&output](const unsigned char* data, size_t size) {
+            output.append(reinterpret_cast<const char*>(data), size);
+        }, std::move(options));
+        auto stmt = conn.prepare(sql);
+        auto result = stmt.execute_query();
+        writer.write(result);
+        writer.finish();
+        return output;
+    }
+
+    std::uint64_t read_little_endian(const std::string& data, size_t& offset, size_t num_bytes)
+    {
+        std::uint64_t value = 0;
+        for (size_t i = 0; i < num_bytes; ++i)
+        {
+            value |= std::uint64_t{static_cast<unsigned char>(data[offset + i])} << (8 * i);
+        }
+        offset += num_bytes;
+        return value;
+    }
+}
+
+SCENARIO("result sets can be written as CSV, NDJSON and a binary format")
+{
+    GIVEN("a database connection and a query with fields of every fundamental type")
+    {
+        sqlitemm::Connection conn(":memory:");
+        sqlitemm::ResultWriterOptions options;
+
+        WHEN("the result set is written as CSV")
+        {
+            auto output = write_to_string(conn, values_sql, options);
+
+            THEN("the fields are formatted and quoted as per RFC 4180, after a header row")
+            {
+                REQUIRE(output ==
+                    "id,name,score,note,data\r\n"
+                    "1,plain,2.5,,00FF10\r\n"
+                    "-42,\"has \"\"quotes\"\", comma\",1e+100,\"line\nbreak\",\r\n");
+            }
+        }
+
+        WHEN("the result set is written as CSV without a header row")
+        {
+            options.header = false;
+            auto output = write_to_string(conn, "SELECT 7, 'x';", options);
+
+            THEN("only the rows are written")
+            {
+                REQUIRE(output == "7,x\r\n");
+            }
+        }
+
+        WHEN("the result set is written as NDJSON")
+        {
+            options.format = sqlitemm::ResultFormat::NdJson;
+            auto output = write_to_string(conn, values_sql, options);
+
+            THEN("each row is a JSON object on its own line")
+            {
+                REQUIRE(output ==
+                    "{\"id\":1,\"name\":\"plain\",\"score\":2.5,\"note\":null,\"data\":\"AP8Q\"}\n"
+                    "{\"id\":-42,\"name\":\"has \\\"quotes\\\", comma\",\"score\":1e+100,"
+                    "\"note\":\"line\\nbreak\",\"data\":\"\"}\n");
+            }
+        }
+
+        WHEN("text with control characters and BLOBs of every length modulo 3 are written as NDJSON")
+        {
+            options.format = sqlitemm::ResultFormat::NdJson;
+            auto output = write_to_string(
+                conn, "SELECT char(1) || 'a\\b' AS \"k\"\"ey\", x'66' AS b1, x'666F' AS b2, x'666F6F' AS b3;", options
+            );
+
+            THEN("they are escaped and base64 encoded")
+            {
+                REQUIRE(output == "{\"k\\\"ey\":\"\\u0001a\\\\b\",\"b1\":\"Zg==\",\"b2\":\"Zm8=\",\"b3\":\"Zm9v\"}\n");
+            }
+        }
+
+        WHEN("the result set is written in the binary format")
+        {
+            options.format = sqlitemm::ResultFormat::Binary;
+            auto output = write_to_string(conn, "SELECT 300 AS n, 0.5 AS r, 'hi' AS t, x'0102' AS b, NULL AS z;", options);
+
+            THEN("the column names and then the typed, length-prefixed fields are written")
+            {
+                size_t offset = 0;
+                REQUIRE(read_little_endian(output, offset, 4) == 5);
+                for (auto name : {"n", "r", "t", "b", "z"})
+                {
+                    auto size = read_little_endian(output, offset, 4);
+                    REQUIRE(output.substr(offset, size) == name);
+                    offset += size;
+                }
+
+                REQUIRE(output[offset++] == SQLITE_INTEGER);
+                REQUIRE(read_little_endian(output, offset, 8) == 300);
+                REQUIRE(output[offset++] == SQLITE_FLOAT);
+                auto bits = read_little_endian(output, offset, 8);
+                double real;
+                std::memcpy(&real, &bits, sizeof(real));
+                REQUIRE(real == 0.5);
+                REQUIRE(output[offset++] == SQLITE_TEXT);
+                REQUIRE(read_little_endian(output, offset, 4) == 2);
+                REQUIRE(output.substr(offset, 2) == "hi");
+                offset += 2;
+                REQUIRE(output[offset++] == SQLITE_BLOB);
+                REQUIRE(read_little_endian(output, offset, 4) == 2);
+                REQUIRE(output.substr(offset, 2) == std::string("\x01\x02"));
+                offset += 2;
+                REQUIRE(output[offset++] == SQLITE_NULL);
+                REQUIRE(offset == output.size());
+            }
+        }
+    }
+}
+
+SCENARIO("result writers hand their output over in chunks, optionally compressed")
+{
+    GIVEN("a query with many rows and a small chunk size")
+    {
+        sqlitemm::Connection conn(":memory:");
+        const std::string sql =
+            "WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 1000) SELECT x, x * x FROM n;";
+        sqlitemm::ResultWriterOptions options;
+        options.header = false;
+        options.chunk_size = 256;
+        std::string expected;
+        for (int x = 1; x <= 1000; ++x)
+        {
+            expected += std::to_string(x) + "," + std::to_string(x * x) + "\r\n";
+        }
+
+        WHEN("the result set is written")
+        {
+            std::vector<std::string> chunks;
+            size_t num_rows = 0;
+            {
+                sqlitemm::ResultWriter writer([&chunks](const unsigned char* data, size_t size) {
+                    chunks.emplace_back(reinterpret_cast<const char*>(data), size);
+                }, options);
+                auto stmt = conn.prepare(sql);
+                auto result = stmt.execute_query();
+                num_rows = writer.write(result);
+            }
+
+            THEN("every row is written across several chunks that end at row boundaries")
+            {
+                REQUIRE(num_rows == 1000);
+                REQUIRE(chunks.size() > 1);
+                std::string output;
+                for (const auto& chunk : chunks)
+                {
+                    REQUIRE(chunk.size() >= 2);
+                    REQUIRE(chunk.substr(chunk.size() - 2) == "\r\n");
+                    output += chunk;
+                }
+                REQUIRE(output == expected);
+            }
+        }
+
+        WHEN("the result set is written with chunks compressed on several threads")
+        {
+            options.compression_threads = 3;
+            options.compressor = [](const unsigned char* data, size_t size) {
+                // stands in for a real compressor by framing the chunk
+                std::vector<unsigned char> framed;
+                framed.push_back('[');
+                framed.insert(framed.end(), data, data + size);
+                framed.push_back(']');
+                return framed;
+            };
+            std::string output;
+            sqlitemm::ResultWriter writer([&output](const unsigned char* data, size_t size) {
+                output.append(reinterpret_cast<const char*>(data), size);
+            }, options);
+            auto stmt = conn.prepare(sql);
+            auto result = stmt.execute_query();
+            writer.write(result);
+            writer.finish();
+
+            THEN("the compressed chunks are handed over in order")
+            {
+                std::string unframed;
+                for (char c : output)
+                {
+                    if (c != '[' && c != ']')
+                    {
+                        unframed += c;
+                    }
+                }
+                REQUIRE(unframed == expected);
+                REQUIRE(output.front() == '[');
+                REQUIRE(output.back() == ']');
+                REQUIRE(output.find("][") != std::string::npos);
+            }
+        }
+
+        WHEN("the result set is written to a file descriptor")
+        {
+            auto file = std::tmpfile();
+            REQUIRE(file);
+            {
+                sqlitemm::ResultWriter writer(fileno(file), options);
+                auto stmt = conn.prepare(sql);
+                auto result = stmt.execute_query();
+                writer.write(result);
+                writer.finish();
+            }
+
+            THEN("the file has every row")
+            {
+                std::rewind(file);
+                std::string output;
+                char buffer[4096];
+                for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;)
+                {
+                    output.append(buffer, n);
+                }
+                std::fclose(file);
+                REQUIRE(output == expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,140 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::Savepoint
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "sqlitemm.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    std::vector<std::string> select_names(sqlitemm::Connection& conn)
+    {
+        auto select_statement = conn.prepare("SELECT name FROM item ORDER BY id");
+        auto result = select_statement.execute_query();
+        std::vector<std::string> names;
+        while (result.step())
+        {
+            names.push_back(result[0]);
+        }
+        return names;
+    }
+}
+
+SCENARIO("savepoints allow partial rollback within a transaction")
+{
+    GIVEN("a database connection with a table with a unique column created")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT UNIQUE)"));
+
+        WHEN("each row of a batch is inserted within a savepoint and one row violates a constraint")
+        {
+            {
+                auto transaction = conn.begin_transaction();
+                auto insert_statement = conn.prepare("INSERT INTO item (name) VALUES (?)");
+                for (auto name : {"ball", "cup", "ball", "plate"})
+                {
+                    auto savepoint = conn.begin_savepoint();
+                    try
+                    {
+                        insert_statement << name;
+                        insert_statement.execute();
+                        savepoint.release();
+                    }
+                    catch (const sqlitemm::ConstraintError& e)
+                    {
+                        savepoint.rollback();
+                        // resetting reports the error of the failed execution once more
+                        REQUIRE_THROWS_AS(insert_statement.reset(), sqlitemm::ConstraintError);
+                    }
+                    insert_statement.reset();
+                }
+                transaction.commit();
+            }
+
+            THEN("only the bad row is rolled back")
+            {
+                REQUIRE(select_names(conn) == std::vector<std::string>{"ball", "cup", "plate"});
+            }
+        }
+
+        WHEN("an exception is thrown within nested savepoints")
+        {
+            {
+                auto transaction = conn.begin_transaction();
+                conn.execute("INSERT INTO item (name) VALUES ('ball')");
+                auto outer = conn.begin_savepoint();
+                conn.execute("INSERT INTO item (name) VALUES ('cup')");
+                try
+                {
+                    auto inner = conn.begin_savepoint();
+                    conn.execute("INSERT INTO item (name) VALUES ('plate')");
+                    throw std::runtime_error("test exception");
+                }
+                catch (const std::exception& e)
+                {
+                    // do nothing
+                }
+                outer.release();
+                transaction.commit();
+            }
+
+            THEN("only the changes since the inner savepoint are rolled back")
+            {
+                REQUIRE(select_names(conn) == std::vector<std::string>{"ball", "cup"});
+            }
+        }
+
+        WHEN("the outer savepoint is rolled back after the inner savepoint is released")
+        {
+            {
+                auto transaction = conn.begin_transaction();
+                conn.execute("INSERT INTO item (name) VALUES ('ball')");
+                auto outer = conn.begin_savepoint();
+                {
+                    auto inner = conn.begin_savepoint();
+                    conn.execute("INSERT INTO item (name) VALUES ('cup')");
+                    inner.release();
+                }
+                outer.rollback();
+                transaction.commit();
+            }
+
+            THEN("the changes since the outer savepoint are rolled back")
+            {
+                REQUIRE(select_names(conn) == std::vector<std::string>{"ball"});
+            }
+        }
+
+        WHEN("a savepoint is begun without a transaction and reused")
+        {
+            auto savepoint = conn.begin_savepoint();
+            conn.execute("INSERT INTO item (name) VALUES ('ball')");
+            savepoint.release();
+
+            THEN("releasing the savepoint commits its changes")
+            {
+                REQUIRE_THROWS_AS(conn.execute("COMMIT"), sqlitemm::Error);
+                savepoint.begin();
+                conn.execute("INSERT INTO item (name) VALUES ('cup')");
+                savepoint.rollback();
+                REQUIRE_THROWS_AS(conn.execute("COMMIT"), sqlitemm::Error);
+                REQUIRE(select_names(conn) == std::vector<std::string>{"ball"});
+            }
+        }
+    }
+}
@@ -0,0 +1,148 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::Script
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <string>
+#include <vector>
+#include "sqlitemm.hpp"
+#include "catch.hpp"
+
+SCENARIO("scripts of SQL statements can be prepared once and executed repeatedly")
+{
+    GIVEN("a database connection and a script that creates and populates a table")
+    {
+        sqlitemm::Connection conn(":memory:");
+        auto script = conn.prepare_script(
+            "CREATE TABLE IF NOT EXISTS notes (id INTEGER PRIMARY KEY, content TEXT);\n"
+            "-- a comment between statements\n"
+            "INSERT INTO notes (content) VALUES ('first');  \n"
+            "INSERT INTO notes (content) VALUES (:content);\n"
+        );
+
+        WHEN("the script is executed for the first time")
+        {
+            REQUIRE(script.size() == 0);
+            script.execute([](size_t index, sqlitemm::Statement& statement) {
+                if (index == 2)
+                {
+                    statement[":content"] = "second";
+                }
+            });
+
+            THEN("each statement is prepared as it is reached, after the schema changes before it")
+            {
+                REQUIRE(script.size() == 3);
+                auto stmt = conn.prepare("SELECT group_concat(content, ',') FROM notes;");
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "first,second");
+            }
+
+            AND_WHEN("the script is executed again")
+            {
+                script.execute([](size_t index, sqlitemm::Statement& statement) {
+                    if (index == 2)
+                    {
+                        statement[":content"] = std::string("third");
+                    }
+                });
+
+                THEN("the statements prepared the first time are reused")
+                {
+                    REQUIRE(script.size() == 3);
+                    auto stmt = conn.prepare("SELECT COUNT(*) FROM notes;");
+                    auto result = stmt.execute_query();
+                    REQUIRE(result.step());
+                    REQUIRE(static_cast<int>(result[0]) == 4);
+                }
+            }
+        }
+    }
+
+    GIVEN("a database connection with a table and a script that updates and queries it")
+    {
+        sqlitemm::Connection conn(":memory:");
+        conn.execute(
+            "CREATE TABLE item (name TEXT, price INTEGER);"
+            "INSERT INTO item VALUES ('pen', 2), ('ink', 5), ('paper', 1);"
+        );
+        auto script = conn.prepare_script(
+            "UPDATE item SET price = price + ?;"
+            "SELECT name FROM item WHERE price > ? ORDER BY name;"
+            "SELECT SUM(price) FROM item;"
+        );
+
+        WHEN("the script is executed with a result reader")
+        {
+            std::vector<std::string> names;
+            int total = 0;
+            script.execute(
+                [](size_t index, sqlitemm::Statement& statement) {
+                    if (index < 2)
+                    {
+                        statement.bind(index == 0 ? 2 : 3);
+                    }
+                },
+                [&names, &total](size_t index, sqlitemm::Result& result) {
+                    while (result.step())
+                    {
+                        if (index == 1)
+                        {
+                            names.push_back(result[0]);
+                        }
+                        else
+                        {
+                            total = result[0];
+                        }
+                    }
+                }
+            );
+
+            THEN("the rows of every statement that returns results are read")
+            {
+                REQUIRE(names == std::vector<std::string>{"ink", "pen"});
+                REQUIRE(total == 14);
+            }
+        }
+    }
+
+    GIVEN("a database connection and a script with a syntax error in its last statement")
+    {
+        sqlitemm::Connection conn(":memory:");
+        auto script = conn.prepare_script("CREATE TABLE notes (content TEXT); INSERT INTO notes VALUES ('a'); SELEC 1;");
+
+        WHEN("every statement of the script is prepared up front")
+        {
+            THEN("the error is reported before anything is executed")
+            {
+                REQUIRE_THROWS_AS(script.prepare_all(), sqlitemm::Error);
+                REQUIRE(script.size() == 1);
+                REQUIRE_THROWS_AS(conn.execute("SELECT * FROM notes;"), sqlitemm::Error);
+            }
+        }
+
+        WHEN("the script is executed")
+        {
+            THEN("the statements before the error are executed")
+            {
+                REQUIRE_THROWS_AS(script.execute(), sqlitemm::Error);
+                REQUIRE(script.size() == 2);
+                auto stmt = conn.prepare("SELECT COUNT(*) FROM notes;");
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<int>(result[0]) == 1);
+            }
+        }
+    }
+}
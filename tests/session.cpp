@@ -0,0 +1,255 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::Session
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "sqlitemm_session.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    const char* schema = "CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, quantity INTEGER);";
+
+    std::string contents(sqlitemm::Connection& conn)
+    {
+        auto stmt = conn.prepare("SELECT group_concat(id || ':' || name || ':' || quantity, ',') "
+                                 "FROM (SELECT * FROM item ORDER BY id);");
+        auto result = stmt.execute_query();
+        result.step();
+        return result[0].to_optional<std::string>().value_or("");
+    }
+}
+
+SCENARIO("changes captured by a session can be applied to another database")
+{
+    GIVEN("a source and a replica database with the same rows, and a session on the source")
+    {
+        sqlitemm::Connection source(":memory:");
+        sqlitemm::Connection replica(":memory:");
+        for (auto* conn : {&source, &replica})
+        {
+            conn->execute(schema);
+            conn->execute("INSERT INTO item (id, name, quantity) VALUES (1, 'apple', 10), (2, 'pear', 20);");
+        }
+        sqlitemm::Session session(source);
+        session.attach_all();
+        REQUIRE(session.enabled());
+        REQUIRE(session.empty());
+
+        WHEN("rows are inserted, updated and deleted in a committed transaction")
+        {
+            auto transaction = source.begin_transaction();
+            source.execute("INSERT INTO item (id, name, quantity) VALUES (3, 'plum', 30);");
+            source.execute("UPDATE item SET quantity = 11 WHERE id = 1;");
+            source.execute("DELETE FROM item WHERE id = 2;");
+            transaction.commit();
+
+            THEN("the changeset brings the replica up to date")
+            {
+                REQUIRE_FALSE(session.empty());
+                auto changeset = session.changeset();
+                REQUIRE_FALSE(changeset.empty());
+                sqlitemm::Session::apply(replica, sqlitemm::BlobView(changeset.data(), changeset.size()));
+                REQUIRE(contents(replica) == "1:apple:11,3:plum:30");
+                REQUIRE(contents(replica) == contents(source));
+            }
+
+            THEN("the patchset is no larger than the changeset and also brings the replica up to date")
+            {
+                auto changeset = session.changeset();
+                auto patchset = session.patchset();
+                REQUIRE(patchset.size() <= changeset.size());
+                sqlitemm::Session::apply(replica, sqlitemm::BlobView(patchset.data(), patchset.size()));
+                REQUIRE(contents(replica) == contents(source));
+            }
+
+            THEN("the changeset can be streamed out and in, in small chunks")
+            {
+                std::vector<std::vector<unsigned char>> chunks;
+                session.changeset([&chunks](const unsigned char* data, std::size_t size) {
+                    chunks.emplace_back(data, data + size);
+                });
+                REQUIRE_FALSE(chunks.empty());
+
+                std::vector<unsigned char> streamed;
+                for (const auto& chunk : chunks)
+                {
+                    streamed.insert(streamed.end(), chunk.begin(), chunk.end());
+                }
+                REQUIRE(streamed == session.changeset());
+
+                std::size_t offset = 0;
+                sqlitemm::Session::apply_stream(replica, [&streamed, &offset](unsigned char* buffer, std::size_t capacity) {
+                    auto size = std::min<std::size_t>({capacity, 7, streamed.size() - offset});
+                    std::copy_n(streamed.begin() + static_cast<std::ptrdiff_t>(offset), size, buffer);
+                    offset += size;
+                    return size;
+                });
+                REQUIRE(offset == streamed.size());
+                REQUIRE(contents(replica) == contents(source));
+            }
+
+            THEN("a filter limits the tables whose changes are applied")
+            {
+                auto changeset = session.changeset();
+                std::vector<std::string> tables;
+                sqlitemm::Session::apply(
+                    replica, sqlitemm::BlobView(changeset.data(), changeset.size()), {},
+                    [&tables](std::string_view table) {
+                        tables.emplace_back(table);
+                        return false;
+                    }
+                );
+                REQUIRE(tables == std::vector<std::string>{"item"});
+                REQUIRE(contents(replica) == "1:apple:10,2:pear:20");
+            }
+        }
+
+        WHEN("a transaction is rolled back")
+        {
+            auto transaction = source.begin_transaction();
+            source.execute("INSERT INTO item (id, name, quantity) VALUES (3, 'plum', 30);");
+            transaction.rollback();
+
+            THEN("its changes are not in the changeset")
+            {
+                REQUIRE(session.changeset().empty());
+            }
+        }
+
+        WHEN("the session is disabled while rows are changed")
+        {
+            session.enable(false);
+            source.execute("DELETE FROM item;");
+
+            THEN("the changes are not recorded")
+            {
+                REQUIRE_FALSE(session.enabled());
+                REQUIRE(session.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("conflicts when applying a changeset are passed to the conflict handler")
+{
+    GIVEN("a changeset, and a replica whose rows have diverged from the source")
+    {
+        sqlitemm::Connection source(":memory:");
+        sqlitemm::Connection replica(":memory:");
+        for (auto* conn : {&source, &replica})
+        {
+            conn->execute(schema);
+            conn->execute("INSERT INTO item (id, name, quantity) VALUES (1, 'apple', 10);");
+        }
+        replica.execute("INSERT INTO item (id, name, quantity) VALUES (2, 'fig', 5);"
+                        "UPDATE item SET quantity = 99 WHERE id = 1;");
+
+        std::vector<unsigned char> changeset;
+        {
+            sqlitemm::Session session(source);
+            session.attach("item");
+            source.execute("INSERT INTO item (id, name, quantity) VALUES (2, 'pear', 20);"
+                           "UPDATE item SET quantity = 11 WHERE id = 1;");
+            changeset = session.changeset();
+        }
+        sqlitemm::BlobView changeset_view(changeset.data(), changeset.size());
+
+        WHEN("the changeset is applied with a handler that replaces the conflicting rows")
+        {
+            std::vector<sqlitemm::ConflictType> conflicts;
+            std::optional<long long> original_quantity;
+            std::optional<long long> conflicting_quantity;
+            sqlitemm::Session::apply(replica, changeset_view, [&](const sqlitemm::ChangesetConflict& conflict) {
+                conflicts.push_back(conflict.type());
+                REQUIRE(conflict.table() == "item");
+                REQUIRE(conflict.column_count() == 3);
+                if (conflict.type() == sqlitemm::ConflictType::Data)
+                {
+                    REQUIRE(conflict.operation() == sqlitemm::ChangeOperation::Update);
+                    original_quantity = conflict.old_value<long long>(2);
+                    conflicting_quantity = conflict.conflicting_value<long long>(2);
+                    REQUIRE_FALSE(conflict.new_value<std::optional<std::string>>(1));
+                }
+                return sqlitemm::ConflictAction::Replace;
+            });
+
+            THEN("the handler is told about each conflict and the rows of the changeset win")
+            {
+                std::sort(conflicts.begin(), conflicts.end());
+                REQUIRE(conflicts == std::vector<sqlitemm::ConflictType>{
+                    sqlitemm::ConflictType::Data, sqlitemm::ConflictType::Conflict
+                });
+                REQUIRE(original_quantity == 10);
+                REQUIRE(conflicting_quantity == 99);
+                REQUIRE(contents(replica) == "1:apple:11,2:pear:20");
+            }
+        }
+
+        WHEN("the changeset is applied with a handler that replaces a row that does not exist")
+        {
+            replica.execute("DELETE FROM item WHERE id = 1;");
+
+            THEN("applying it fails with SQLITE_MISUSE and no change is applied")
+            {
+                try
+                {
+                    sqlitemm::Session::apply(replica, changeset_view, [](const sqlitemm::ChangesetConflict&) {
+                        return sqlitemm::ConflictAction::Replace;
+                    });
+                    FAIL("apply did not throw");
+                }
+                catch (const sqlitemm::Error& e)
+                {
+                    REQUIRE(e.code() == SQLITE_MISUSE);
+                    REQUIRE_THAT(e.what(), Catch::Contains("only valid for Data and Conflict conflicts"));
+                }
+                REQUIRE(contents(replica) == "2:fig:5");
+            }
+        }
+
+        WHEN("the changeset is applied with a handler that omits the conflicting changes")
+        {
+            sqlitemm::Session::apply(replica, changeset_view, [](const sqlitemm::ChangesetConflict&) {
+                return sqlitemm::ConflictAction::Omit;
+            });
+
+            THEN("the rows of the replica are kept")
+            {
+                REQUIRE(contents(replica) == "1:apple:99,2:fig:5");
+            }
+        }
+
+        WHEN("the changeset is applied without a conflict handler, or with one that throws")
+        {
+            THEN("applying it fails and no change is applied")
+            {
+                REQUIRE_THROWS_AS(sqlitemm::Session::apply(replica, changeset_view), sqlitemm::Error);
+                REQUIRE_THROWS_AS(
+                    sqlitemm::Session::apply(replica, changeset_view, [](const sqlitemm::ChangesetConflict&) {
+                        throw std::runtime_error("unexpected conflict");
+                        return sqlitemm::ConflictAction::Omit;
+                    }),
+                    std::runtime_error
+                );
+                REQUIRE(contents(replica) == "1:apple:99,2:fig:5");
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::SharedSnapshot
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "sqlitemm_snapshot.hpp"
+#include "catch.hpp"
+
+SCENARIO("a database file mapped once can be shared by many read-only connections")
+{
+    GIVEN("a snapshot of a database file with rows")
+    {
+        const std::string filename = "snapshot_test.db";
+        {
+            sqlitemm::Connection conn(filename);
+            conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, value INTEGER);"
+                         "WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 1000) "
+                         "INSERT INTO item (id, value) SELECT x, x * 2 FROM n;");
+        }
+        {
+            sqlitemm::SharedSnapshot snapshot(filename);
+
+            WHEN("connections to the snapshot are used for lookups on several threads")
+            {
+                const int num_threads = 4;
+                std::vector<long long> totals(num_threads, 0);
+                std::vector<std::thread> readers;
+                for (int thread = 0; thread < num_threads; ++thread)
+                {
+                    readers.emplace_back([&snapshot, &totals, thread] {
+                        auto conn = snapshot.connect();
+                        auto stmt = conn.prepare("SELECT value FROM item WHERE id = ?;");
+                        for (int id = 1; id <= 1000; ++id)
+                        {
+                            auto result = stmt.query(id);
+                            if (result.step())
+                            {
+                                totals[thread] += static_cast<long long>(result[0]);
+                            }
+                        }
+                    });
+                }
+                for (auto& reader : readers)
+                {
+                    reader.join();
+                }
+
+                THEN("every lookup finds its row")
+                {
+                    REQUIRE(snapshot.size() > 0);
+                    for (auto total : totals)
+                    {
+                        REQUIRE(total == 1000 * 1001);
+                    }
+                }
+            }
+
+            WHEN("a connection to the snapshot tries to write")
+            {
+                auto conn = snapshot.connect();
+
+                THEN("an exception is thrown and the rows are unchanged")
+                {
+                    REQUIRE_THROWS_AS(conn.execute("DELETE FROM item;"), sqlitemm::Error);
+                    auto stmt = conn.prepare("SELECT COUNT(*) FROM item;");
+                    auto result = stmt.execute_query();
+                    REQUIRE(result.step());
+                    REQUIRE(static_cast<int>(result[0]) == 1000);
+                }
+            }
+        }
+        std::remove(filename.c_str());
+    }
+
+    GIVEN("a database file that does not exist")
+    {
+        WHEN("a snapshot of it is created")
+        {
+            THEN("an exception is thrown")
+            {
+                REQUIRE_THROWS_AS(sqlitemm::SharedSnapshot("snapshot_test_missing.db"), std::system_error);
+            }
+        }
+    }
+}
@@ -14,7 +14,12 @@
  ************************************************************************************************************/
 
 #include <limits>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include "sqlitemm.hpp"
 #include "catch.hpp"
 
@@ -152,6 +157,81 @@ SCENARIO("prepared statement can bind named parameters using indexed assignment"
     }
 }
 
+SCENARIO("prepared statement can bind named parameters through stored parameter handles")
+{
+    GIVEN("a database connection with a table created")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(
+            conn.execute("CREATE TABLE result (id INTEGER PRIMARY KEY, name TEXT, games INTEGER, score REAL)")
+        );
+        auto insert_statement = conn.prepare(
+            "INSERT INTO result (name, games, score) VALUES (:name, @games, $score)"
+        );
+
+        WHEN("the parameters are looked up once and bound for each row")
+        {
+            auto name = insert_statement.parameter(":name");
+            auto games = insert_statement.parameter("@games");
+            auto score = insert_statement.parameter("$score");
+            for (int i = 0; i < 3; ++i)
+            {
+                name = "player" + std::to_string(i);
+                games = i;
+                score = i * 1.5;
+                REQUIRE_NOTHROW(insert_statement.execute());
+                REQUIRE_NOTHROW(insert_statement.reset());
+            }
+
+            THEN("the same rows can be retrieved")
+            {
+                auto select_statement = conn.prepare("SELECT name, games, score FROM result ORDER BY id");
+                auto result = select_statement.execute_query();
+                for (int i = 0; i < 3; ++i)
+                {
+                    std::string name;
+                    int games;
+                    double score;
+                    REQUIRE(result.step());
+                    REQUIRE_NOTHROW(result >> name >> games >> score);
+                    REQUIRE(name == "player" + std::to_string(i));
+                    REQUIRE(games == i);
+                    REQUIRE(score == Approx(i * 1.5));
+                }
+                REQUIRE_FALSE(result.step());
+            }
+        }
+
+        WHEN("a parameter name that does not exist is looked up")
+        {
+            THEN("an error is thrown")
+            {
+                REQUIRE_THROWS_AS(insert_statement.parameter(":games"), sqlitemm::Error);
+                REQUIRE_THROWS_AS(insert_statement[":nonexistent"], sqlitemm::Error);
+                REQUIRE_NOTHROW(insert_statement[std::string("@games")]);
+            }
+        }
+
+        WHEN("the prepared statement is moved after a lookup")
+        {
+            REQUIRE_NOTHROW(insert_statement.parameter(":name"));
+            auto moved_statement = std::move(insert_statement);
+            moved_statement[":name"] = "Alice";
+            moved_statement["@games"] = 1;
+            moved_statement["$score"] = 2.5;
+            REQUIRE_NOTHROW(moved_statement.execute());
+
+            THEN("the moved prepared statement can still bind by name")
+            {
+                auto select_statement = conn.prepare("SELECT name FROM result");
+                auto result = select_statement.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "Alice");
+            }
+        }
+    }
+}
+
 namespace
 {
     template<typename T>
@@ -1002,3 +1082,301 @@ TEST_CASE("Statement::operator[](const std::string&)")
         }
     }
 }
+
+SCENARIO("prepared statement can execute many rows in one call")
+{
+    GIVEN("a database connection with a table created")
+    {
+        sqlitemm::Connection conn(":memory:");
+        REQUIRE_NOTHROW(
+            conn.execute("CREATE TABLE result (id INTEGER PRIMARY KEY, name TEXT UNIQUE, games INTEGER, score REAL)")
+        );
+        auto insert_statement = conn.prepare("INSERT INTO result (name, games, score) VALUES (?, ?, ?)");
+
+        WHEN("a range of tuples is executed")
+        {
+            std::vector<std::tuple<std::string, int, double>> rows{
+                {"Alice", 20, 12.3}, {"Bob", 25, 11.5}, {"Charlie", 30, 10.4}
+            };
+            auto stats = insert_statement.execute_many(rows);
+
+            THEN("every row is inserted without any transaction being committed")
+            {
+                REQUIRE(stats.rows == 3);
+                REQUIRE(stats.commits == 0);
+                REQUIRE(stats.seconds >= 0.0);
+                auto select_statement = conn.prepare("SELECT name, games, score FROM result ORDER BY id");
+                auto result = select_statement.execute_query();
+                std::string name;
+                int games;
+                double score;
+                REQUIRE(result.step());
+                REQUIRE_NOTHROW(result >> name >> games >> score);
+                REQUIRE(name == "Alice");
+                REQUIRE(games == 20);
+                REQUIRE(score == Approx(12.3));
+                REQUIRE(result.step());
+                REQUIRE(result.step());
+                REQUIRE_NOTHROW(result >> name >> games >> score);
+                REQUIRE(name == "Charlie");
+                REQUIRE(games == 30);
+                REQUIRE(score == Approx(10.4));
+                REQUIRE_FALSE(result.step());
+            }
+        }
+
+        WHEN("a range of structs is executed with a binder and a commit interval")
+        {
+            struct GameResult
+            {
+                std::string name;
+                int games;
+                double score;
+            };
+            std::vector<GameResult> rows;
+            for (int i = 0; i < 10; ++i)
+            {
+                rows.push_back({"player" + std::to_string(i), i, i * 1.5});
+            }
+            auto stats = insert_statement.execute_many(rows, [](sqlitemm::Statement& statement, const GameResult& row) {
+                statement << row.name << row.games << row.score;
+            }, 4);
+
+            THEN("every row is inserted in transactions of at most the commit interval")
+            {
+                REQUIRE(stats.rows == 10);
+                REQUIRE(stats.commits == 3);
+                auto select_statement = conn.prepare("SELECT COUNT(*), SUM(games) FROM result");
+                auto result = select_statement.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<int>(result[0]) == 10);
+                REQUIRE(static_cast<int>(result[1]) == 45);
+            }
+        }
+
+        WHEN("a row fails part way through with a commit interval")
+        {
+            std::vector<std::tuple<std::string, int, double>> rows{
+                {"Alice", 20, 12.3}, {"Bob", 25, 11.5}, {"Charlie", 30, 10.4}, {"Alice", 35, 9.6}
+            };
+            REQUIRE_THROWS_AS(insert_statement.execute_many(rows, 2), sqlitemm::ConstraintError);
+
+            THEN("only the rows since the last commit are rolled back")
+            {
+                auto select_statement = conn.prepare("SELECT name FROM result ORDER BY id");
+                auto result = select_statement.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "Alice");
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "Bob");
+                REQUIRE_FALSE(result.step());
+            }
+        }
+
+        WHEN("the rows are executed within an existing transaction")
+        {
+            std::vector<std::pair<std::string, int>> rows{{"Alice", 20}, {"Bob", 25}};
+            auto pair_statement = conn.prepare("INSERT INTO result (name, games) VALUES (?, ?)");
+            {
+                auto transaction = conn.begin_transaction();
+                auto stats = pair_statement.execute_many(rows, 1);
+                REQUIRE(stats.commits == 0);
+            }
+
+            THEN("committing is left to the existing transaction")
+            {
+                auto select_statement = conn.prepare("SELECT COUNT(*) FROM result");
+                auto result = select_statement.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<int>(result[0]) == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("statements can be executed and stepped without throwing exceptions")
+{
+    GIVEN("a table with a unique column and a row")
+    {
+        sqlitemm::Connection conn(":memory:");
+        conn.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT UNIQUE);");
+        conn.execute("INSERT INTO item (id, name) VALUES (1, 'apple');");
+
+        WHEN("an insert that violates the unique constraint is executed with try_execute")
+        {
+            auto stmt = conn.prepare("INSERT INTO item (name) VALUES (:name);");
+            stmt[":name"] = "apple";
+            auto status = stmt.try_execute();
+
+            THEN("the constraint violation is reported as a status")
+            {
+                REQUIRE_FALSE(status.ok());
+                REQUIRE_FALSE(status);
+                REQUIRE(status.constraint_violation());
+                REQUIRE_FALSE(status.busy());
+                REQUIRE(status.code() == SQLITE_CONSTRAINT_UNIQUE);
+                REQUIRE(status.message().find("UNIQUE constraint failed") != std::string::npos);
+                REQUIRE_THROWS_AS(status.throw_if_error(), sqlitemm::ConstraintError);
+            }
+
+            THEN("the statement can be reset and executed again without throwing")
+            {
+                REQUIRE(stmt.try_reset().constraint_violation());
+                stmt[":name"] = "pear";
+                REQUIRE(stmt.try_execute().code() == SQLITE_DONE);
+                REQUIRE(stmt.try_reset().ok());
+                REQUIRE_NOTHROW(sqlitemm::Status().throw_if_error());
+            }
+        }
+
+        WHEN("a query is stepped through with try_step")
+        {
+            auto stmt = conn.prepare("SELECT name FROM item;");
+            auto result = stmt.execute_query();
+
+            THEN("each row is reported as a status with a row, followed by SQLITE_DONE")
+            {
+                auto status = result.try_step();
+                REQUIRE(status.ok());
+                REQUIRE(status.has_row());
+                REQUIRE(static_cast<std::string>(result[0]) == "apple");
+                status = result.try_step();
+                REQUIRE(status.ok());
+                REQUIRE_FALSE(status.has_row());
+                REQUIRE(status.code() == SQLITE_DONE);
+            }
+        }
+    }
+}
+
+SCENARIO("text and BLOBs are bound without copies")
+{
+    GIVEN("a prepared statement that selects its parameters")
+    {
+        sqlitemm::Connection conn(":memory:");
+        auto stmt = conn.prepare("SELECT :text, :blob, typeof(:text), typeof(:blob);");
+
+        WHEN("a string view and a BLOB view are bound")
+        {
+            const std::string text = "borrowed text";
+            const unsigned char bytes[] = {0x00, 0x01, 0x02};
+            stmt << std::string_view(text).substr(0, 8) << sqlitemm::BlobView(bytes, sizeof(bytes));
+
+            THEN("the viewed contents are bound")
+            {
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                std::string_view selected_text = result[0];
+                sqlitemm::BlobView selected_blob = result[1];
+                REQUIRE(selected_text == "borrowed");
+                REQUIRE(selected_blob == sqlitemm::BlobView(bytes, sizeof(bytes)));
+            }
+        }
+
+        WHEN("empty views are bound by name")
+        {
+            stmt[":text"] = std::string_view();
+            stmt[":blob"] = sqlitemm::BlobView();
+
+            THEN("they are bound as empty text and an empty BLOB rather than NULL")
+            {
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[2]) == "text");
+                REQUIRE(static_cast<std::string>(result[3]) == "blob");
+                REQUIRE(sqlitemm::BlobView(result[1]).empty());
+            }
+        }
+
+        WHEN("strings are moved into the bindings and the statement is reset without clearing them")
+        {
+            stmt << std::string(1000, 'x');
+            stmt[":blob"] = std::u16string(u"moved");
+            {
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+            }
+            stmt.reset();
+
+            THEN("the statement owns the moved strings until the bindings are cleared")
+            {
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                std::string_view selected_text = result[0];
+                REQUIRE(selected_text == std::string(1000, 'x'));
+                REQUIRE(static_cast<std::u16string>(result[1]) == u"moved");
+                REQUIRE_FALSE(result.step());
+                stmt.reset(true);
+                auto cleared_result = stmt.execute_query();
+                REQUIRE(cleared_result.step());
+                REQUIRE(cleared_result[0].to_optional<std::string>() == std::nullopt);
+            }
+        }
+    }
+}
+
+SCENARIO("parameters are bound and statements executed in one call")
+{
+    GIVEN("a table and a prepared insert statement")
+    {
+        sqlitemm::Connection conn(":memory:");
+        conn.execute("CREATE TABLE result (id INTEGER PRIMARY KEY, name TEXT, games INTEGER, score REAL, note TEXT);");
+        auto insert = conn.prepare("INSERT INTO result (id, name, games, score, note) VALUES (?, ?, ?, ?, ?);");
+
+        WHEN("rows are inserted with execute and values of various types")
+        {
+            const std::string name = "Alice";
+            insert.execute(1, name, 20u, 12.5, nullptr);
+            insert.execute(2, std::string("Bob"), 3000000000LL, 1.0f, std::optional<std::string_view>("note"));
+            insert.execute(std::make_tuple(3, "Carol", static_cast<short>(7), 2.5, std::optional<int>()));
+
+            THEN("each row is stored as bound")
+            {
+                auto select = conn.prepare("SELECT name, games, score, note FROM result WHERE id = ?;");
+                auto result = select.query(1);
+                REQUIRE(result.step());
+                REQUIRE(result.row<std::string, long long, double, std::optional<std::string>>() ==
+                        std::make_tuple(std::string("Alice"), 20LL, 12.5, std::optional<std::string>()));
+                result = select.query(2);
+                REQUIRE(result.step());
+                REQUIRE(result.row<std::string, long long, double, std::optional<std::string>>() ==
+                        std::make_tuple(std::string("Bob"), 3000000000LL, 1.0, std::optional<std::string>("note")));
+                result = select.query(std::make_tuple(3));
+                REQUIRE(result.step());
+                REQUIRE(result.row<std::string, long long>() == std::make_tuple(std::string("Carol"), 7LL));
+            }
+        }
+
+        WHEN("the number of values does not match the number of parameters")
+        {
+            THEN("sqlitemm::Error is thrown without executing the statement")
+            {
+                try
+                {
+                    insert.execute(1, "Alice");
+                    FAIL("binding too few values did not throw");
+                }
+                catch (const sqlitemm::Error& e)
+                {
+                    REQUIRE(e.code() == SQLITE_RANGE);
+                }
+                REQUIRE_THROWS_AS(insert.bind(1, "Alice", 20, 12.5, nullptr, 0), sqlitemm::Error);
+                auto count = conn.prepare("SELECT COUNT(*) FROM result;");
+                auto result = count.query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<int>(result[0]) == 0);
+            }
+        }
+
+        WHEN("an execution fails and the statement is executed again")
+        {
+            insert.execute(1, "Alice", 20, 12.5, nullptr);
+            REQUIRE_THROWS_AS(insert.execute(1, "Alice", 20, 12.5, nullptr), sqlitemm::ConstraintError);
+
+            THEN("the error of the previous execution is not thrown again")
+            {
+                REQUIRE_NOTHROW(insert.execute(2, "Bob", 10, 5.0, nullptr));
+            }
+        }
+    }
+}
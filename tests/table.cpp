@@ -0,0 +1,110 @@
+/************************************************************************************************************
+ * SQLitemm tests source file primarily for testing sqlitemm::Table
+ *
+ * Copyright 2025 Amanda Wee
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ ************************************************************************************************************/
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "sqlitemm_table.hpp"
+#include "catch.hpp"
+
+namespace
+{
+    struct Player
+    {
+        long long id = 0;
+        std::string name;
+        std::optional<double> score;
+    };
+}
+
+SCENARIO("rows of a table are mapped to and from a struct")
+{
+    GIVEN("a table mapped to a struct, with the columns in a different order from the table")
+    {
+        sqlitemm::Connection conn(":memory:");
+        conn.execute("CREATE TABLE \"player list\" (score REAL, name TEXT NOT NULL, id INTEGER PRIMARY KEY);");
+        sqlitemm::Table players(
+            conn, "player list",
+            sqlitemm::column("id", &Player::id),
+            sqlitemm::column("name", &Player::name),
+            sqlitemm::column("score", &Player::score)
+        );
+
+        WHEN("objects are inserted")
+        {
+            REQUIRE(players.insert(Player{3, "Alice", 12.5}) == 3);
+            REQUIRE(players.insert(Player{1, "Bob", std::nullopt}) == 1);
+
+            THEN("they can be found by primary key")
+            {
+                auto alice = players.find(3);
+                REQUIRE(alice);
+                REQUIRE(alice->id == 3);
+                REQUIRE(alice->name == "Alice");
+                REQUIRE(alice->score == 12.5);
+
+                auto bob = players.find(1);
+                REQUIRE(bob);
+                REQUIRE(bob->name == "Bob");
+                REQUIRE_FALSE(bob->score);
+
+                REQUIRE_FALSE(players.find(2));
+            }
+
+            THEN("every row can be scanned")
+            {
+                auto all = players.scan();
+                REQUIRE(all.size() == 2);
+                REQUIRE(all[0].name == "Bob");
+                REQUIRE(all[1].name == "Alice");
+
+                double total = 0.0;
+                players.scan([&total](const Player& player) { total += player.score.value_or(0.0); });
+                REQUIRE(total == 12.5);
+            }
+
+            THEN("the columns are written to the mapped columns of the table")
+            {
+                auto stmt = conn.prepare("SELECT name FROM \"player list\" WHERE score > 10;");
+                auto result = stmt.execute_query();
+                REQUIRE(result.step());
+                REQUIRE(static_cast<std::string>(result[0]) == "Alice");
+            }
+
+            THEN("an object with a duplicate primary key cannot be inserted")
+            {
+                REQUIRE_THROWS_AS(players.insert(Player{3, "Carol", 1.0}), sqlitemm::ConstraintError);
+            }
+        }
+    }
+
+    GIVEN("a mapping to a column that does not exist")
+    {
+        sqlitemm::Connection conn(":memory:");
+        conn.execute("CREATE TABLE player (id INTEGER PRIMARY KEY, name TEXT);");
+
+        WHEN("the table object is constructed")
+        {
+            THEN("an exception is thrown")
+            {
+                REQUIRE_THROWS_AS(
+                    sqlitemm::Table(conn, "player", sqlitemm::column("id", &Player::id),
+                                    sqlitemm::column("rating", &Player::score)),
+                    sqlitemm::Error
+                );
+            }
+        }
+    }
+}
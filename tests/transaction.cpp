@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and limitations under the License.
  ************************************************************************************************************/
 
+#include <cstdio>
+#include <string>
 #include "sqlitemm.hpp"
 #include "catch.hpp"
 
@@ -235,3 +237,61 @@ SCENARIO("transactions are used to group statements")
         }
     }
 }
+
+SCENARIO("transactions can be begun with a locking mode")
+{
+    GIVEN("two database connections to the same database file with a table created")
+    {
+        const std::string filename = "transaction_mode_test.db";
+        std::remove(filename.c_str());
+        {
+            sqlitemm::Connection conn1(filename);
+            sqlitemm::Connection conn2(filename);
+            REQUIRE_NOTHROW(conn1.execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT)"));
+
+            WHEN("an immediate transaction is begun on one connection")
+            {
+                auto transaction = conn1.begin_transaction(sqlitemm::TransactionMode::Immediate);
+
+                THEN("the other connection can begin a deferred transaction to read but not an immediate one")
+                {
+                    REQUIRE_THROWS_AS(conn2.begin_transaction(sqlitemm::TransactionMode::Immediate),
+                                      sqlitemm::BusyError);
+                    auto read_transaction = conn2.begin_transaction();
+                    auto select_statement = conn2.prepare("SELECT COUNT(*) FROM item");
+                    auto result = select_statement.execute_query();
+                    REQUIRE(result.step());
+                    REQUIRE(static_cast<int>(result[0]) == 0);
+                }
+
+                THEN("the transaction holds the write lock until it is committed")
+                {
+                    REQUIRE_NOTHROW(conn1.execute("INSERT INTO item (name) VALUES ('ball')"));
+                    transaction.commit();
+                    REQUIRE_NOTHROW(conn2.begin_transaction(sqlitemm::TransactionMode::Exclusive).commit());
+                }
+            }
+
+            WHEN("a transaction is begun within a transaction")
+            {
+                auto transaction = conn1.begin_transaction(sqlitemm::TransactionMode::Exclusive);
+
+                THEN("an error is thrown with SQLite's error message, and the outer transaction is unaffected")
+                {
+                    try
+                    {
+                        conn1.begin_transaction();
+                        FAIL("expected an exception");
+                    }
+                    catch (const sqlitemm::Error& e)
+                    {
+                        REQUIRE(std::string(e.what()).find("within a transaction") != std::string::npos);
+                    }
+                    REQUIRE_NOTHROW(conn1.execute("INSERT INTO item (name) VALUES ('ball')"));
+                    REQUIRE_NOTHROW(transaction.commit());
+                }
+            }
+        }
+        std::remove(filename.c_str());
+    }
+}